@@ -9,10 +9,16 @@
 
 // -------------------------------------------------------------------------- //
 
+// Needed for the POSIX Functions (Threads, Clocks) when compiling with -std=c11
+#define _POSIX_C_SOURCE 200809L
+// Needed for mmap-Flags and madvise-Hints which are not part of POSIX
+#define _DEFAULT_SOURCE
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -21,6 +27,7 @@
 #define EASY 0
 #define ACTUAL 1
 #define COMPLICATED 2
+#define PACKED 3
 
 // Which Variant of the Program to use
 // Variant 0 = Easy Variant => Uses a 2d-Cell Array and can display the
@@ -40,8 +47,25 @@
 //                             Cells and can (theoretically) play the game into
 //                             Infinity (in practive until an Integer Overflow
 //                             occurs or Memory runs out).
+// Variant 3 = Packed      =>  Stores every Cell as a single Bit and calculates
+//                             64 Cells at once using Bit-sliced Kernels,
+//                             which are specialised for the most used Rules.
 #define VARIANT COMPLICATED
 
+#define DEAD_EDGES 0
+#define TORUS 1
+
+// What lies beyond the Edges of the Board in the Grid-Variants (Easy,
+// Actual Sol. and Packed)
+// Dead Edges => Every Cell outside of the Board is dead.
+// Torus      => The Board wraps around, so Cells on the left Edge are
+//               Neighbours of the Cells on the right Edge and Cells on the
+//               top Edge are Neighbours of the Cells on the bottom Edge.
+// The Complicated Variant has no Edges and ignores this Option.
+#ifndef TOPOLOGY
+    #define TOPOLOGY DEAD_EDGES
+#endif
+
 #define u8 uint8_t
 
 // -------------------------------------------------------------------------- //
@@ -56,6 +80,8 @@ int game_of_life(int argc, char* argv[]);
     #include "src/actual.c"
 #elif VARIANT == COMPLICATED
     #include "src/complicated.c"
+#elif VARIANT == PACKED
+    #include "src/packed.c"
 #else
     _Static_assert(true, "Please provide an acutal Variant!")
 #endif
@@ -64,7 +90,12 @@ int game_of_life(int argc, char* argv[]);
 
 int main (int argc, char* argv[]) {
 
-    return game_of_life(argc, argv);
+    int result = game_of_life(argc, argv);
+
+    // Summary of the Phase Timers (only if compiled with PROFILE)
+    PROFILE_REPORT();
+
+    return result;
 
 }
 
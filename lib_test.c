@@ -0,0 +1,247 @@
+// -------------------------------------------------------------------------- //
+// --- Explanation ---------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Checks the Library (see src/gol.h) the Way a Program uses it, linked
+// against libgol.a and only through the Functions of the Header.
+//
+//      make lib-test
+//
+// Prints OK/FAILED for every Check and returns EXIT_FAILURE if one failed.
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "gol.h"
+
+#define RED "\x1B[31m"
+#define GREEN "\x1B[32m"
+#define DEFAULT "\x1B[0m"
+
+// Cells of a Glider flying to the bottom right, 1 Cell every 4 Generations
+static const int glider[5][2] = {{1, 0}, {2, 1}, {0, 2}, {1, 2}, {2, 2}};
+
+// Cells the Callback has seen
+struct Seen {
+    int count;
+    // Number of Cells which are not part of the moved Glider
+    int unexpected;
+    int x;
+    int y;
+};
+
+// -------------------------------------------------------------------------- //
+
+int check (const char * name, int ok);
+int count_cell (void * ctx, int x, int y);
+int stop_at_first (void * ctx, int x, int y);
+int test_glider ();
+int test_rows ();
+int test_generic_rule ();
+int test_errors ();
+
+// -------------------------------------------------------------------------- //
+
+int main () {
+
+    printf(RED "Library\n" DEFAULT);
+
+    int errors = test_glider();
+    errors += test_rows();
+    errors += test_generic_rule();
+    errors += test_errors();
+
+    return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Print the Result of a Check, returns 1 if it failed
+int check (const char * name, int ok) {
+    printf("\t%-40s: %s\n", name, ok ? GREEN "OK" DEFAULT : RED "FAILED" DEFAULT);
+    return ok ? 0 : 1;
+}
+
+// Count the Cell and check that it belongs to the Glider at (ctx->x, ctx->y)
+int count_cell (void * ctx, int x, int y) {
+    struct Seen * seen = ctx;
+    int found = 0;
+    for (int iLauf = 0; iLauf < 5; iLauf ++) {
+        if ((x == seen->x + glider[iLauf][0]) && (y == seen->y + glider[iLauf][1])) found = 1;
+    }
+    seen->count ++;
+    if (!found) seen->unexpected ++;
+    return 0;
+}
+
+// Stops the Iteration at the first Cell
+int stop_at_first (void * ctx, int x, int y) {
+    struct Seen * seen = ctx;
+    seen->count ++;
+    seen->x = x;
+    seen->y = y;
+    return 42;
+}
+
+// -------------------------------------------------------------------------- //
+
+// A Glider crossing the Border between the first two Words of a Row has
+// moved by (1, 1) after 4 Generations
+int test_glider () {
+
+    GolBoard * board;
+    if (gol_create(&board, 100, 70, NULL) != GOL_OK) return check("Create a Board", 0);
+
+    const int x = 61;
+    const int y = 10;
+    for (int iLauf = 0; iLauf < 5; iLauf ++) {
+        gol_set(board, x + glider[iLauf][0], y + glider[iLauf][1], 1);
+    }
+    int errors = check("Population of the Glider", gol_population(board) == 5);
+
+    errors += check("Step 4 Generations", gol_step(board, 4) == GOL_OK);
+    errors += check("Generation after 4 Steps", gol_generation(board) == 4);
+
+    int moved = 1;
+    for (int iLauf = 0; iLauf < 5; iLauf ++) {
+        if (gol_get(board, x + 1 + glider[iLauf][0], y + 1 + glider[iLauf][1]) != 1) moved = 0;
+    }
+    errors += check("Glider moved by (1, 1)", moved && (gol_population(board) == 5));
+
+    struct Seen seen = {0, 0, x + 1, y + 1};
+    const int result = gol_for_each_alive(board, count_cell, &seen);
+    errors += check(
+        "Callback called for every alive Cell",
+        (result == GOL_OK) && (seen.count == 5) && (seen.unexpected == 0)
+    );
+
+    // The Cells are visited Row by Row, so the first one is the Top of the
+    // Glider
+    struct Seen first = {0, 0, 0, 0};
+    errors += check(
+        "Callback stops the Iteration",
+        (gol_for_each_alive(board, stop_at_first, &first) == 42) &&
+        (first.count == 1) && (first.x == x + 2) && (first.y == y + 1)
+    );
+
+    gol_destroy(board);
+    return errors;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Read a random Soup through GolRows on a Width which is not a Multiple of
+// 64 and compare it with gol_get
+int test_rows () {
+
+    const int width = 100;
+    const int height = 37;
+    GolBoard * board;
+    if (gol_create(&board, width, height, "B3/S23") != GOL_OK) return check("Create a Board", 0);
+
+    int errors = check("Fill with a random Soup", gol_fill_random(board, 0.5, 1234) == GOL_OK);
+    errors += check("Step 3 Generations", gol_step(board, 3) == GOL_OK);
+
+    GolRows view;
+    errors += check("Get the Rows", gol_rows(board, &view) == GOL_OK);
+    errors += check(
+        "Words and Tail Mask of the Rows",
+        (view.words == 2) && (view.stride >= view.words) &&
+        (view.tail_mask == ((1ULL << (width % 64)) - 1))
+    );
+
+    long population = 0;
+    int mismatches = 0;
+    for (int iLauf = 0; iLauf < height; iLauf ++) {
+        const uint64_t * row = view.rows + iLauf * view.stride;
+        for (long iLauf2 = 0; iLauf2 < view.words; iLauf2 ++) {
+            uint64_t word = row[iLauf2];
+            if (iLauf2 == (view.words - 1)) word &= view.tail_mask;
+            population += __builtin_popcountll(word);
+        }
+        for (int iLauf2 = 0; iLauf2 < width; iLauf2 ++) {
+            const int alive = (row[iLauf2 / 64] >> (iLauf2 % 64)) & 1;
+            if (alive != gol_get(board, iLauf2, iLauf)) mismatches ++;
+        }
+    }
+    errors += check("Rows hold the same Cells as gol_get", mismatches == 0);
+    errors += check(
+        "Population of the Rows",
+        (population > 0) && (population == gol_population(board))
+    );
+
+    gol_destroy(board);
+    return errors;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// B2/S has no specialised Kernel, a Domino turns into two Dominos above and
+// below it. A second Board with another Rule is stepped in between.
+int test_generic_rule () {
+
+    GolBoard * seeds;
+    GolBoard * other;
+    if (gol_create(&seeds, 30, 20, "B2/S") != GOL_OK) return check("Create a Board", 0);
+    if (gol_create(&other, 30, 20, "B36/S125") != GOL_OK) {
+        gol_destroy(seeds);
+        return check("Create a Board", 0);
+    }
+
+    gol_set(seeds, 10, 5, 1);
+    gol_set(seeds, 11, 5, 1);
+    gol_fill_random(other, 0.4, 99);
+    gol_step(other, 1);
+    gol_step(seeds, 1);
+    gol_step(other, 1);
+
+    const int ok =
+        (gol_population(seeds) == 4) &&
+        gol_get(seeds, 10, 4) && gol_get(seeds, 11, 4) &&
+        gol_get(seeds, 10, 6) && gol_get(seeds, 11, 6);
+    int errors = check("Generic Rule B2/S", ok);
+
+    gol_destroy(seeds);
+    gol_destroy(other);
+    return errors;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+int test_errors () {
+
+    // Any Value other than NULL, gol_create has to reset it on an Error
+    GolBoard * board = (GolBoard *) &board;
+    int errors = check(
+        "Invalid Rule",
+        (gol_create(&board, 10, 10, "B3/X23") == GOL_ERROR_RULE) && (board == NULL)
+    );
+    errors += check("Invalid Size", gol_create(&board, 0, 10, NULL) == GOL_ERROR_ARGUMENT);
+    errors += check("No Handle", gol_create(NULL, 10, 10, NULL) == GOL_ERROR_ARGUMENT);
+
+    if (gol_create(&board, 10, 10, NULL) != GOL_OK) return errors + check("Create a Board", 0);
+    errors += check(
+        "Invalid Arguments",
+        (gol_set(board, 10, 0, 1) == GOL_ERROR_ARGUMENT) &&
+        (gol_set(board, 0, -1, 1) == GOL_ERROR_ARGUMENT) &&
+        (gol_step(board, -1) == GOL_ERROR_ARGUMENT) &&
+        (gol_fill_random(board, 1.5, 0) == GOL_ERROR_ARGUMENT) &&
+        (gol_for_each_alive(board, NULL, NULL) == GOL_ERROR_ARGUMENT) &&
+        (gol_rows(board, NULL) == GOL_ERROR_ARGUMENT)
+    );
+    gol_destroy(board);
+
+    return errors;
+
+}
+
+// -------------------------------------------------------------------------- //
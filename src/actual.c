@@ -5,7 +5,9 @@
 #define FALSE false
 
 // Prints Output to .pbm Files
-#define TO_FILE TRUE
+#ifndef TO_FILE
+    #define TO_FILE TRUE
+#endif
 // Run in Debug-Mode => Displays Neighbour-Count
 // This Option only has an Effect if TO_FILE is false
 #define DEBUG TRUE
@@ -14,68 +16,410 @@
     #define DEBUG FALSE
 #endif
 
-// Delay between rounds when the Game is displayed on the Terminal.
-#define DELAY 0.5
+// Delay between rounds (in ms) when the Game is displayed on the Terminal.
+// Can be changed using --delay-ms or --fps.
+#ifndef DELAY_MS
+    #define DELAY_MS 500
+#endif
+
+// Calculate the Generations in 2x2 Blocks using a Lookup-Table, which holds
+// the next State of the Centre of every possible 4x4 Block, instead of
+// calculating every Cell on its own.
+#ifndef BLOCK_LOOKUP
+    #define BLOCK_LOOKUP TRUE
+#endif
+
+// Store the Board in Tiles which are ordered along a Z-Curve (see morton.c)
+// instead of Row by Row while calculating the Generations.
+#ifndef MORTON_LAYOUT
+    #define MORTON_LAYOUT FALSE
+#endif
+
+// Number of Threads calculating a Generation (0 = one per online CPU)
+#ifndef THREADS
+    #define THREADS 0
+#endif
+
+// Because of all the Options sometimes the Compiler would complain
+// about unused Parameters which would be needed for other Options.
+// This Macro is a No-OP but suppresses the Unused Warning.
+#define UNUSED(x) (void)(x)
+
+// -------------------------------------------------------------------------- //
+
+#include "options.c"
+#include "profile.c"
+#include "scheduler.c"
+#include "stats.c"
+#include "morton.c"
+
+// Arguments for step_tile, which is called by the Scheduler
+struct StepContext {
+    bool ** src;
+    bool ** dest;
+    int width;
+    int height;
+};
+
+struct Scheduler scheduler;
+
+// Statistics of every Generation (only used with --stats)
+struct StatsStream stats_stream;
+
+// Frames shown on the Terminal (only used if TO_FILE is FALSE)
+struct Renderer renderer;
+// Draws the Frames with --render-thread
+struct RenderThread render_thread;
+
+// Animated GIF of the Generations (only used with --gif)
+struct GifWriter gif;
+// Compressed Stream of the Generations (only used with --frames)
+struct FrameStream frame_stream;
+
+// Arguments for the Tile Functions of the Morton Layout
+struct MortonContext {
+    struct MortonGrid * src;
+    struct MortonGrid * dest;
+};
+
+struct MortonGrid morton_grids[2];
+
+// Cell (row, col) of the 4x4 Block with the Index idx
+// Row 0 is stored in the highest 4 Bits and Column 0 is the highest Bit of
+// each Row.
+#define BLOCK_CELL(idx, row, col) (((idx) >> (15 - (4 * (row) + (col)))) & 1)
+
+// Next State of the 2x2 Centre of every 4x4 Block
+// Bit 3 = (1, 1), Bit 2 = (1, 2), Bit 1 = (2, 1), Bit 0 = (2, 2)
+u8 block_table[1 << 16];
 
 // -------------------------------------------------------------------------- //
 
 int game_of_life(int argc, char* argv[]);
-void printUsage(const char* programName);
 bool *** init (int width, int height, double density);
 void uninit(bool *** cells, int height);
 int print_cells_to_file(bool ** cells, int iStep, int width, int height);
-void main_loop (bool *** cells, int width, int height, int steps);
-void print_cells(bool ** cells, int width, int height);
+int main_loop (bool *** cells, int width, int height, int steps);
+int print_cells(bool ** cells, int width, int height, int round, bool last);
+void pack_cells (bool ** cells, int width, int height, uint64_t * bits);
+int record_cells (bool ** cells, int width, int height, int generation);
 void swap(bool *** a, bool *** b);
+void step_tile (void * ctx, struct Tile tile);
+void exchange_halo (bool ** cells, int width, int height);
+void init_block_table (const struct Rule * rule);
+void step_block_tile (void * ctx, struct Tile tile);
+void step_grid_tile (void * ctx, struct Tile tile);
+void count_tile_stats (bool ** src, bool ** dest, struct Tile tile, long x_offset, long y_offset);
+void exchange_morton (void * ctx, struct Tile tile);
+void step_morton_tile (void * ctx, struct Tile tile);
 
 // -------------------------------------------------------------------------- //
 
-void printUsage(const char* programName) {
-    printf("usage: %s <width> <height> <density> <steps>\n", programName);
-}
+// TEST is set/defined via the Command Line using <gcc game.c -DTEST>
+#ifndef TEST
 
-// -------------------------------------------------------------------------- //
+    int game_of_life(int argc, char* argv[]) {
+        if(argc < 5) {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        if (parse_options(argc, argv, &options) < 0) {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        // The Board has Bounds, so all its Cells fit into --frames
+        if (options.sparse_path != NULL) {
+            printf("--sparse is only supported by the Complicated Variant\n");
+            return EXIT_FAILURE;
+        }
+        // The other Variants keep the State of their Board in Globals
+        if ((options.batch_path != NULL) || (options.census_path != NULL)) {
+            printf("--batch and --census are only supported by the Packed Variant\n");
+            return EXIT_FAILURE;
+        }
+        if (start_trace(options.trace, options.trace_path) < 0) {
+            printf("Could not start the Trace\n");
+            return EXIT_FAILURE;
+        }
+
+        const int width = atoi(argv[1]);
+        const int height = atoi(argv[2]);
+        const double density = atof(argv[3]);
+        const int steps = atoi(argv[4]);
+
+        // Seeding the random number generator so we get a different starting field
+        // every time.
+        srand(time(NULL));
+
+        // Get temporary Screen, saving the current Terminal Output and hide the
+        // Cursor
+        printf("\x1B[?1049h\x1B[?25l");
+
+        // Allocate a 2d-Array using Malloc
+        bool *** cells = init(width, height, density);
+
+        #if BLOCK_LOOKUP == TRUE
+            init_block_table(&options.rule);
+        #endif
+
+        // Start the Threads calculating the Generations
+        #if MORTON_LAYOUT == TRUE
+            // Every Tile of the Scheduler is one Tile of the Grid
+            int error = init_scheduler_tiles(&scheduler, THREADS, width, height, MORTON_TILE, MORTON_TILE);
+            if ((error == 0) && (init_morton(&morton_grids[0], width, height) < 0)) {
+                error = -1;
+            } else if ((error == 0) && (init_morton(&morton_grids[1], width, height) < 0)) {
+                uninit_morton(&morton_grids[0]);
+                error = -1;
+            }
+            if (error < 0) uninit_scheduler(&scheduler);
+        #else
+            int error = init_scheduler(&scheduler, THREADS, width, height);
+        #endif
+        if (error < 0) {
+            printf("\x1B[?1049l\x1B[?25h");
+            printf("Could not start the Scheduler\n");
+            uninit(cells, height);
+            stop_trace();
+            return EXIT_FAILURE;
+        }
+
+        if (
+            (options.stats_path != NULL) &&
+            (open_stats(&stats_stream, options.stats_path, scheduler.num_threads) < 0)
+        ) {
+            printf("\x1B[?1049l\x1B[?25h");
+            printf("Could not open the Statistics File \"%s\"\n", options.stats_path);
+            #if MORTON_LAYOUT == TRUE
+                uninit_morton(&morton_grids[0]);
+                uninit_morton(&morton_grids[1]);
+            #endif
+            uninit_scheduler(&scheduler);
+            uninit(cells, height);
+            stop_trace();
+            return EXIT_FAILURE;
+        }
+
+        if (
+            (options.gif_path != NULL) &&
+            (open_gif(&gif, options.gif_path, width, height, options.gif_scale, options.gif_delay) < 0)
+        ) {
+            printf("\x1B[?1049l\x1B[?25h");
+            printf("Could not create the GIF \"%s\"\n", options.gif_path);
+            close_stats(&stats_stream);
+            #if MORTON_LAYOUT == TRUE
+                uninit_morton(&morton_grids[0]);
+                uninit_morton(&morton_grids[1]);
+            #endif
+            uninit_scheduler(&scheduler);
+            uninit(cells, height);
+            stop_trace();
+            return EXIT_FAILURE;
+        }
 
-int game_of_life(int argc, char* argv[]) {
-    if(argc != 5) {
-        printUsage(argv[0]);
-        return EXIT_FAILURE;
+        if (
+            (options.frames_path != NULL) &&
+            (open_frame_stream(&frame_stream, options.frames_path, width, height) < 0)
+        ) {
+            printf("\x1B[?1049l\x1B[?25h");
+            printf("Could not create the Frame Stream \"%s\"\n", options.frames_path);
+            close_gif(&gif);
+            close_stats(&stats_stream);
+            #if MORTON_LAYOUT == TRUE
+                uninit_morton(&morton_grids[0]);
+                uninit_morton(&morton_grids[1]);
+            #endif
+            uninit_scheduler(&scheduler);
+            uninit(cells, height);
+            stop_trace();
+            return EXIT_FAILURE;
+        }
+
+        #if TO_FILE == FALSE
+            if (init_renderer(&renderer, options.view, width, height, options.render_fps) < 0) {
+                printf("\x1B[?1049l\x1B[?25h");
+                printf("Could not allocate the Frames for the Terminal\n");
+                close_frame_stream(&frame_stream);
+                close_gif(&gif);
+                close_stats(&stats_stream);
+                #if MORTON_LAYOUT == TRUE
+                    uninit_morton(&morton_grids[0]);
+                    uninit_morton(&morton_grids[1]);
+                #endif
+                uninit_scheduler(&scheduler);
+                uninit(cells, height);
+                stop_trace();
+                return EXIT_FAILURE;
+            }
+            if (options.render_thread && (start_render_thread(&render_thread, &renderer) < 0)) {
+                printf("\x1B[?1049l\x1B[?25h");
+                printf("Could not start the Render Thread\n");
+                uninit_renderer(&renderer);
+                close_frame_stream(&frame_stream);
+                close_gif(&gif);
+                close_stats(&stats_stream);
+                #if MORTON_LAYOUT == TRUE
+                    uninit_morton(&morton_grids[0]);
+                    uninit_morton(&morton_grids[1]);
+                #endif
+                uninit_scheduler(&scheduler);
+                uninit(cells, height);
+                stop_trace();
+                return EXIT_FAILURE;
+            }
+        #endif
+
+        // Loop for the Amount specified in Steps
+        int result = main_loop(cells, width, height, steps);
+
+        #if TO_FILE == FALSE
+            // Draw the last Snapshot before the Terminal is restored
+            if (options.render_thread && (stop_render_thread(&render_thread) < 0)) {
+                fprintf(stderr, "Could not write to the Terminal\n");
+                result = -1;
+            }
+        #endif
+
+        // Restore Terminal Output and show the cursor again
+        printf("\x1B[?1049l\x1B[?25h");
+
+        if (close_frame_stream(&frame_stream) < 0) {
+            printf("Could not write the Frame Stream \"%s\"\n", options.frames_path);
+            result = -1;
+        }
+        if (close_gif(&gif) < 0) {
+            printf("Could not write the GIF \"%s\"\n", options.gif_path);
+            result = -1;
+        }
+        close_stats(&stats_stream);
+        #if TO_FILE == FALSE
+            uninit_renderer(&renderer);
+        #endif
+        #if MORTON_LAYOUT == TRUE
+            uninit_morton(&morton_grids[0]);
+            uninit_morton(&morton_grids[1]);
+        #endif
+        uninit_scheduler(&scheduler);
+        uninit(cells, height);
+        stop_trace();
+
+        return (result < 0) ? EXIT_FAILURE : EXIT_SUCCESS;
     }
 
-    const int width = atoi(argv[1]);
-    const int height = atoi(argv[2]);
-    const double density = atof(argv[3]);
-    const int steps = atoi(argv[4]);
+#else
 
-    // Seeding the random number generator so we get a different starting field
-    // every time.
-    srand(time(NULL));
+    // Compare the Block-Kernel and the Morton Layout with the Cell-Kernel on
+    // random Boards for some Rules and both odd and even Sizes.
+    int game_of_life(int argc, char* argv[]) {
 
-    // Get temporary Screen, saving the current Terminal Output and hide the
-    // Cursor
-    printf("\x1B[?1049h\x1B[?25l");
+        UNUSED(argc);
+        UNUSED(argv);
 
-    // Allocate a 2d-Array using Malloc
-    bool *** cells = init(width, height, density);
+        const char * rules[] = {"B3/S23", "B36/S23", "B0/S8", "B2/S", "B3678/S34678"};
+        const int sizes[][2] = {{200, 100}, {203, 101}, {257, 33}, {1, 1}};
+        const int steps = 20;
+        int errors = 0;
 
-    // Loop for the Amount specified in Steps
-    main_loop(cells, width, height, steps);
+        srand(42);
 
-    // Restore Terminal Output and show the cursor again
-    printf("\x1B[?1049l\x1B[?25h");
+        for (unsigned iRule = 0; iRule < (sizeof(rules) / sizeof(rules[0])); iRule ++) {
+            parse_rule(rules[iRule], &options.rule);
+            init_block_table(&options.rule);
 
-    uninit(cells, height);
+            for (unsigned iSize = 0; iSize < (sizeof(sizes) / sizeof(sizes[0])); iSize ++) {
+                const int width = sizes[iSize][0];
+                const int height = sizes[iSize][1];
 
-    return EXIT_SUCCESS;
-}
+                bool *** cells = init(width, height, 0.3);
+                bool *** expected = init(width, height, 0.3);
+                if (init_scheduler(&scheduler, THREADS, width, height) < 0) {
+                    printf("Could not start the Scheduler\n");
+                    return EXIT_FAILURE;
+                }
+                if (
+                    (init_morton(&morton_grids[0], width, height) < 0) ||
+                    (init_morton(&morton_grids[1], width, height) < 0)
+                ) {
+                    printf("Could not allocate the Morton Layout\n");
+                    return EXIT_FAILURE;
+                }
+                struct MortonContext morton_ctx = {&morton_grids[0], &morton_grids[1]};
+                struct MortonGrid * temp;
+                morton_from_rows(morton_ctx.src, cells[0]);
+
+                struct StepContext ctx = {
+                    .src = cells[0], .dest = cells[1], .width = width, .height = height
+                };
+                struct StepContext ctx_expected = ctx;
+                ctx_expected.dest = expected[1];
+
+                long mismatches = 0;
+                for (int iStep = 0; iStep < steps; iStep ++) {
+                    exchange_halo(ctx.src, width, height);
+                    run_tiles(&scheduler, step_tile, &ctx_expected);
+                    run_tiles(&scheduler, step_block_tile, &ctx);
+                    for (long iLauf = 0; iLauf < height; iLauf ++) {
+                        if (memcmp(ctx.dest[iLauf], ctx_expected.dest[iLauf], width) != 0) {
+                            mismatches ++;
+                        }
+                    }
+                    // Same Generation using the Morton Layout (Tile by Tile)
+                    for (long iLauf = 0; iLauf < morton_ctx.src->tiles_y * morton_ctx.src->tiles_x; iLauf ++) {
+                        exchange_morton_tile(morton_ctx.src, iLauf % morton_ctx.src->tiles_x, iLauf / morton_ctx.src->tiles_x);
+                    }
+                    for (int iLauf = 0; iLauf < height; iLauf += MORTON_TILE) {
+                        for (int iLauf2 = 0; iLauf2 < width; iLauf2 += MORTON_TILE) {
+                            struct Tile tile = {
+                                iLauf, (iLauf + MORTON_TILE < height) ? iLauf + MORTON_TILE : height,
+                                iLauf2, (iLauf2 + MORTON_TILE < width) ? iLauf2 + MORTON_TILE : width
+                            };
+                            step_morton_tile(&morton_ctx, tile);
+                        }
+                    }
+                    temp = morton_ctx.src;
+                    morton_ctx.src = morton_ctx.dest;
+                    morton_ctx.dest = temp;
+                    morton_to_rows(morton_ctx.src, expected[0]);
+                    for (long iLauf = 0; iLauf < height; iLauf ++) {
+                        if (memcmp(expected[0][iLauf], ctx_expected.dest[iLauf], width) != 0) {
+                            mismatches ++;
+                        }
+                    }
+                    swap(&ctx.src, &ctx.dest);
+                    ctx_expected.src = ctx.src;
+                }
+
+                printf(
+                    "\t%-14s %4d x %4d: %s\n", rules[iRule], width, height,
+                    mismatches ? "\x1B[31mFAILED\x1B[0m" : "\x1B[32mOK\x1B[0m"
+                );
+                if (mismatches) errors ++;
+
+                uninit_morton(&morton_grids[0]);
+                uninit_morton(&morton_grids[1]);
+                uninit_scheduler(&scheduler);
+                uninit(cells, height);
+                uninit(expected, height);
+            }
+        }
+
+        return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+
+    }
+
+#endif
 
 // -------------------------------------------------------------------------- //
 
 // Allocate Memory for 2 2d-Array Game Fields and initialize them
+// Both Fields get a Ring of Ghost Cells around them, so cells[-1][-1] up to
+// cells[height][width] are valid. This way the Neighbours of the Cells on the
+// Edges can be read without checking the Field Boundaries.
 bool *** init (int width, int height, double density) {
 
     // Allocate Array of Pointers to the Arrays containing the Cells
-    bool ** cell_arr1 = malloc (sizeof(bool *) * height);
+    // (including the Ghost Rows above and below the Field)
+    bool ** cell_arr1 = malloc (sizeof(bool *) * (height + 2));
 
     // Check that Malloc worked
     if (!cell_arr1) {
@@ -83,7 +427,7 @@ bool *** init (int width, int height, double density) {
         exit(1);
     }
 
-    bool ** cell_arr2 = malloc (sizeof(bool *) * height);
+    bool ** cell_arr2 = malloc (sizeof(bool *) * (height + 2));
 
     // Check that Malloc worked
     if (!cell_arr2) {
@@ -93,8 +437,6 @@ bool *** init (int width, int height, double density) {
     }
 
     bool *** cells = malloc(sizeof(bool **) * 2);
-    cells[0] = cell_arr1;
-    cells[1] = cell_arr2;
 
     // Check that Malloc worked
     if (!cells) {
@@ -104,13 +446,20 @@ bool *** init (int width, int height, double density) {
         exit(1);
     }
 
+    // Let the Row Pointers start at the first Row of the Field, so the
+    // upper Ghost Row has the Index -1.
+    cells[0] = cell_arr1 + 1;
+    cells[1] = cell_arr2 + 1;
+
     // Multiply the Density by the maximum number that rand() can return
     int i_density = RAND_MAX * density;
 
     // Allocate/Initialize the Arrays of Cells
-    for (long iLauf = 0; iLauf < height; iLauf ++) {
-        // Allocate the Fields side by side using twice the Width of a Board.
-        cell_arr1[iLauf] = malloc(sizeof(bool) * width * 2);
+    for (long iLauf = 0; iLauf < (height + 2); iLauf ++) {
+        // Allocate the Fields side by side using twice the Width of a Board
+        // (plus the Ghost Cells left and right of each Field).
+        // Calloc makes sure that all Ghost Cells start out dead.
+        cell_arr1[iLauf] = calloc((width + 2) * 2, sizeof(bool));
         // Check that Malloc worked
         if (!cell_arr1[iLauf]) {
             printf("Malloc failed\n");
@@ -123,14 +472,14 @@ bool *** init (int width, int height, double density) {
         }
         // Since the Fields are allocated next to each other, the second
         // Board simply points in the middle of the allocated Memory.
-        cell_arr2[iLauf] = cell_arr1[iLauf] + width;
-        // Initialize Cells
-        for (int iLauf2 = 0; iLauf2 < (width * 2); iLauf2 ++) {
-            if (rand() <= i_density) {
-                cell_arr1[iLauf][iLauf2] = true;
-            } else {
-                cell_arr1[iLauf][iLauf2] = false;
-            }
+        // Both Pointers skip the left Ghost Cell.
+        cell_arr2[iLauf] = cell_arr1[iLauf] + width + 3;
+        cell_arr1[iLauf] += 1;
+        // Initialize Cells (the Ghost Rows stay dead)
+        if ((iLauf == 0) || (iLauf == (height + 1))) continue;
+        for (int iLauf2 = 0; iLauf2 < width; iLauf2 ++) {
+            cell_arr1[iLauf][iLauf2] = (rand() <= i_density);
+            cell_arr2[iLauf][iLauf2] = (rand() <= i_density);
         }
     }
 
@@ -143,96 +492,334 @@ bool *** init (int width, int height, double density) {
 // NOTE: I could not find a better name for this funtion
 void uninit(bool *** cells, int height) {
     // Determine which Field has the original Pointers
-    // which were allocated.
+    // which were allocated (one in front of them because of the Ghost Cell).
     if (cells[0][0] < cells[1][0]) {
-        for (long iLauf = 0; iLauf < height; iLauf ++)
-            free(cells[0][iLauf]);
+        for (long iLauf = -1; iLauf <= height; iLauf ++)
+            free(cells[0][iLauf] - 1);
     } else {
-        for (long iLauf = 0; iLauf < height; iLauf ++)
-            free(cells[1][iLauf]);
+        for (long iLauf = -1; iLauf <= height; iLauf ++)
+            free(cells[1][iLauf] - 1);
     }
-    free(cells[0]);
-    free(cells[1]);
+    free(cells[0] - 1);
+    free(cells[1] - 1);
     free(cells);
 }
 
 // -------------------------------------------------------------------------- //
 
+// Fill the Ghost Cells around the Field before a Generation is calculated.
+// With Dead Edges nothing has to be done, because the Ghost Cells are never
+// written and stay dead. On a Torus each Ghost Cell gets a Copy of the
+// Cell on the opposite Edge of the Field.
+void exchange_halo (bool ** cells, int width, int height) {
+    #if TOPOLOGY == TORUS
+        // Left and right Ghost Column
+        for (long iLauf = 0; iLauf < height; iLauf ++) {
+            cells[iLauf][-1] = cells[iLauf][width-1];
+            cells[iLauf][width] = cells[iLauf][0];
+        }
+        // Upper and lower Ghost Row (including the Corners, which were
+        // already wrapped horizontally)
+        memcpy(cells[-1] - 1, cells[height-1] - 1, sizeof(bool) * (width + 2));
+        memcpy(cells[height] - 1, cells[0] - 1, sizeof(bool) * (width + 2));
+    #else
+        UNUSED(cells);
+        UNUSED(width);
+        UNUSED(height);
+    #endif
+}
+
+// -------------------------------------------------------------------------- //
+
 // Loop for the specified amount of Steps
 //      1. Display the Board
 //      2. Calculate the Sum of each Cells alive neighbours
 //      3. Revive dead cells with 3 alive neighbours, kill cells
 //         that do not have 2 or 3 neighbours and reset each Cells
 //         Neighbour Count.
-//      4. Short Delay
-void main_loop (bool *** cells, int width, int height, int steps) {
-
-    int neighbours;
+//      4. Write the Statistics of the new Generation (with --stats)
+//      5. Wait for the next Generation (--fps, --delay-ms)
+// Returns -1 if the Board or the Statistics could not be written.
+int main_loop (bool *** cells, int width, int height, int steps) {
+
+    struct StepContext ctx = {
+        .src = cells[0],
+        .dest = cells[1],
+        .width = width,
+        .height = height
+    };
 
-    bool ** src = cells[0];
-    bool ** dest = cells[1];
+    #if MORTON_LAYOUT == TRUE
+        struct MortonContext morton_ctx = {
+            .src = &morton_grids[0],
+            .dest = &morton_grids[1]
+        };
+        struct MortonGrid * temp;
+        morton_from_rows(morton_ctx.src, ctx.src);
+    #endif
+    PROFILE_TIMER(output);
+    PROFILE_TIMER(compute);
+
+    // Pace the Generations (only if they are shown on the Terminal, unless
+    // a Rate was given)
+    struct Pacer pacer;
+    #if TO_FILE == TRUE
+        init_pacer(&pacer, pace_interval(&options, 0));
+    #else
+        init_pacer(&pacer, pace_interval(&options, DELAY_MS));
+    #endif
 
     for (int iStep = 0; iStep < steps; iStep ++) {
+        PROFILE_START(output);
+        #if MORTON_LAYOUT == TRUE
+            // The Board is displayed Row by Row
+            morton_to_rows(morton_ctx.src, ctx.src);
+        #endif
         // Display the Board (either in a File or on the Terminal)
         #if TO_FILE == TRUE
-            if (print_cells_to_file(src, iStep, width, height) == -1) {
+            // With --gif or --frames the Generations only go there
+            if (
+                (gif.file == NULL) && (frame_stream.file == NULL) &&
+                (print_cells_to_file(ctx.src, iStep, width, height) == -1)
+            ) {
                 // There was an Error with the File
                 // I assume that following Tries will also fail, so I return.
-                uninit(cells, height);
-                return;
+                // (game_of_life frees the Cells afterwards)
+                return -1;
             }
         #else
-            // Some Terminal ANSI-Commands to clear the Screen every Re-Render
-            printf("\x1B[25l\x1B[3J\x1B[0;0H\x1B[34mRound %d:\n\n", iStep + 1);
-            print_cells(dest, width, height);
+            if (print_cells(ctx.src, width, height, iStep + 1, iStep == (steps - 1)) < 0) return -1;
         #endif
-        // Calculate neighbours
-        for (int iLauf = 0; iLauf < height; iLauf++) {
-            for (int iLauf2 = 0; iLauf2 < width; iLauf2++) {
-                // Reset Neighbour Count
-                neighbours = 0;
-                // Count all alive Neighbour Cells
-                // I don't know how to write this more concise, because I have
-                // to test for Field Boundaries
-                if ((iLauf - 1) >= 0) {
-                    neighbours += src[iLauf-1][iLauf2];
-                    if ((iLauf2 - 1) >= 0)
-                        neighbours += src[iLauf-1][iLauf2-1];
-                    if ((iLauf2 + 1) < width)
-                        neighbours += src[iLauf-1][iLauf2+1];
-                }
-                if ((iLauf2 - 1) >= 0)
-                    neighbours += src[iLauf][iLauf2-1];
-                if ((iLauf2 + 1) < width) {
-                    neighbours += src[iLauf][iLauf2+1];
-                }
-                if ((iLauf + 1) < height) {
-                    neighbours += src[iLauf+1][iLauf2];
-                    if ((iLauf2 - 1) >= 0)
-                        neighbours += src[iLauf+1][iLauf2-1];
-                    if ((iLauf2 + 1) < width)
-                        neighbours += src[iLauf+1][iLauf2+1];
-                }
-                // Check if Cell should be alive or dead.
-                if (
-                    ((src[iLauf][iLauf2]) && (neighbours == 2)) ||
-                    (neighbours == 3)
-                ) {
-                    dest[iLauf][iLauf2] = true;
-                } else {
-                    dest[iLauf][iLauf2] = false;
-                }
-            }
+        if (record_cells(ctx.src, width, height, iStep) < 0) {
+            printf("Could not write the GIF or the Frame Stream\n");
+            return -1;
         }
+        PROFILE_STOP(output);
+        PROFILE_START(compute);
+        #if MORTON_LAYOUT == TRUE
+            // Calculate the next Generation Tile by Tile
+            run_tiles(&scheduler, exchange_morton, &morton_ctx);
+            run_tiles(&scheduler, step_morton_tile, &morton_ctx);
+            temp = morton_ctx.src;
+            morton_ctx.src = morton_ctx.dest;
+            morton_ctx.dest = temp;
+        #else
+            // Calculate the next Generation Tile by Tile
+            exchange_halo(ctx.src, width, height);
+            run_tiles(&scheduler, step_grid_tile, &ctx);
+            // Swap Pointers, switching the Fields from the View of the CPU.
+            swap(&ctx.src, &ctx.dest);
+        #endif
+        PROFILE_STOP(compute);
+        PROFILE_START(output);
+        if ((stats_stream.file != NULL) && (write_stats(&stats_stream, iStep + 1) < 0)) {
+            printf("Could not write the Statistics\n");
+            return -1;
+        }
+        PROFILE_STOP(output);
+        PROFILE_FLUSH(output);
+        PROFILE_FLUSH(compute);
+        PROFILE_GENERATION();
         #if DEBUG == TRUE
-            getchar();
+            // Wait for Enter, unless a Rate was given or the Frames are drawn
+            // by the Render Thread
+            if ((options.delay < 0) && !options.render_thread) {
+                getchar();
+            } else {
+                pace(&pacer);
+            }
         #else
-            sleep(DELAY);
+            pace(&pacer);
         #endif
-        // Swap Pointers, switching the Fields from the View of the CPU.
-        swap(&src, &dest);
     }
 
+    return 0;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Calculate the next Generation of all Cells inside the Tile
+// Thanks to the Ghost Cells every Cell has 8 Neighbours which can be read
+// without checking the Field Boundaries.
+void step_tile (void * arg, struct Tile tile) {
+
+    struct StepContext * ctx = arg;
+    bool ** src = ctx->src;
+    bool ** dest = ctx->dest;
+    const bool (* next)[9] = options.rule.next;
+
+    for (int iLauf = tile.y_begin; iLauf < tile.y_end; iLauf++) {
+        const bool * above = src[iLauf-1];
+        const bool * row = src[iLauf];
+        const bool * below = src[iLauf+1];
+        bool * out = dest[iLauf];
+        for (int iLauf2 = tile.x_begin; iLauf2 < tile.x_end; iLauf2++) {
+            // Count all alive Neighbour Cells
+            int neighbours =
+                above[iLauf2-1] + above[iLauf2] + above[iLauf2+1] +
+                row[iLauf2-1]                   + row[iLauf2+1] +
+                below[iLauf2-1] + below[iLauf2] + below[iLauf2+1];
+            // Look up if the Cell is alive in the next Generation
+            out[iLauf2] = next[row[iLauf2]][neighbours];
+        }
+    }
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Calculate the next State of the Centre of every possible 4x4 Block
+void init_block_table (const struct Rule * rule) {
+
+    for (long idx = 0; idx < (1 << 16); idx ++) {
+        u8 next = 0;
+        // Go through the 4 Cells of the Centre
+        for (int iLauf = 1; iLauf <= 2; iLauf ++) {
+            for (int iLauf2 = 1; iLauf2 <= 2; iLauf2 ++) {
+                int neighbours =
+                    BLOCK_CELL(idx, iLauf-1, iLauf2-1) + BLOCK_CELL(idx, iLauf-1, iLauf2) +
+                    BLOCK_CELL(idx, iLauf-1, iLauf2+1) + BLOCK_CELL(idx, iLauf, iLauf2-1) +
+                    BLOCK_CELL(idx, iLauf, iLauf2+1) + BLOCK_CELL(idx, iLauf+1, iLauf2-1) +
+                    BLOCK_CELL(idx, iLauf+1, iLauf2) + BLOCK_CELL(idx, iLauf+1, iLauf2+1);
+                next = (next << 1) | rule->next[BLOCK_CELL(idx, iLauf, iLauf2)][neighbours];
+            }
+        }
+        block_table[idx] = next;
+    }
+
+}
+
+// Calculate the next Generation of the Tile in 2x2 Blocks.
+// Every Block only needs one Lookup, since the 4x4 Block around it contains
+// all Neighbours of its Cells. While moving along the Rows, each of the 4
+// Rows of the Window keeps its right 2 Columns, so only 2 new Cells have to
+// be read per Row.
+// If the Tile has an odd Height or Width, the last Row/Column is calculated
+// using step_tile.
+void step_block_tile (void * arg, struct Tile tile) {
+
+    struct StepContext * ctx = arg;
+    bool ** src = ctx->src;
+    bool ** dest = ctx->dest;
+
+    // End of the Part of the Tile which can be split into whole Blocks
+    int y_end = tile.y_begin + ((tile.y_end - tile.y_begin) & ~1);
+    int x_end = tile.x_begin + ((tile.x_end - tile.x_begin) & ~1);
+
+    for (int iLauf = tile.y_begin; iLauf < y_end; iLauf += 2) {
+        const bool * r0 = src[iLauf-1];
+        const bool * r1 = src[iLauf];
+        const bool * r2 = src[iLauf+1];
+        const bool * r3 = src[iLauf+2];
+        bool * out0 = dest[iLauf];
+        bool * out1 = dest[iLauf+1];
+
+        // Columns left of the first Block
+        int x = tile.x_begin;
+        unsigned w0 = (r0[x-1] << 1) | r0[x];
+        unsigned w1 = (r1[x-1] << 1) | r1[x];
+        unsigned w2 = (r2[x-1] << 1) | r2[x];
+        unsigned w3 = (r3[x-1] << 1) | r3[x];
+
+        for (int iLauf2 = tile.x_begin; iLauf2 < x_end; iLauf2 += 2) {
+            // Move the Window 2 Columns to the right
+            w0 = ((w0 << 2) | (r0[iLauf2+1] << 1) | r0[iLauf2+2]) & 0xF;
+            w1 = ((w1 << 2) | (r1[iLauf2+1] << 1) | r1[iLauf2+2]) & 0xF;
+            w2 = ((w2 << 2) | (r2[iLauf2+1] << 1) | r2[iLauf2+2]) & 0xF;
+            w3 = ((w3 << 2) | (r3[iLauf2+1] << 1) | r3[iLauf2+2]) & 0xF;
+
+            u8 next = block_table[(w0 << 12) | (w1 << 8) | (w2 << 4) | w3];
+            out0[iLauf2] = (next >> 3) & 1;
+            out0[iLauf2+1] = (next >> 2) & 1;
+            out1[iLauf2] = (next >> 1) & 1;
+            out1[iLauf2+1] = next & 1;
+        }
+    }
+
+    // Remaining Row/Column
+    if (y_end < tile.y_end) {
+        step_tile(arg, (struct Tile) {y_end, tile.y_end, tile.x_begin, tile.x_end});
+    }
+    if (x_end < tile.x_end) {
+        step_tile(arg, (struct Tile) {tile.y_begin, y_end, x_end, tile.x_end});
+    }
+
+}
+
+// Calculate the next Generation of the Tile using the Kernel selected by
+// BLOCK_LOOKUP and count its Statistics (with --stats)
+void step_grid_tile (void * arg, struct Tile tile) {
+    struct StepContext * ctx = arg;
+    #if BLOCK_LOOKUP == TRUE
+        step_block_tile(arg, tile);
+    #else
+        step_tile(arg, tile);
+    #endif
+    if (stats_stream.file != NULL) count_tile_stats(ctx->src, ctx->dest, tile, 0, 0);
+}
+
+// Count the Cells of the Tile which was just calculated from src into dest
+// (while it is still in the Cache) and add them to the Slot of the Thread.
+// The Offsets move the Bounding Box from the Coordinates of the Tile to the
+// ones of the Board.
+void count_tile_stats (bool ** src, bool ** dest, struct Tile tile, long x_offset, long y_offset) {
+
+    struct Stats tile_stats;
+    reset_stats(&tile_stats);
+
+    for (int iLauf = tile.y_begin; iLauf < tile.y_end; iLauf++) {
+        const bool * before = src[iLauf];
+        const bool * after = dest[iLauf];
+        for (int iLauf2 = tile.x_begin; iLauf2 < tile.x_end; iLauf2++) {
+            count_cell(&tile_stats, before[iLauf2], after[iLauf2], iLauf2, iLauf);
+        }
+    }
+
+    shift_stats(&tile_stats, x_offset, y_offset);
+    add_tile_stats(&stats_stream.slots[scheduler_thread_index()], &tile_stats);
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Fill the Ghost Cells of a Tile of the Morton Layout
+void exchange_morton (void * arg, struct Tile tile) {
+    struct MortonContext * ctx = arg;
+    exchange_morton_tile(ctx->src, tile.x_begin / MORTON_TILE, tile.y_begin / MORTON_TILE);
+}
+
+// Calculate the next Generation of a Tile of the Morton Layout.
+// The Tile has its own Ghost Cells, so the normal Kernels can calculate it
+// like a small Board.
+void step_morton_tile (void * arg, struct Tile tile) {
+
+    struct MortonContext * ctx = arg;
+    const int tx = tile.x_begin / MORTON_TILE;
+    const int ty = tile.y_begin / MORTON_TILE;
+
+    bool * src_rows[MORTON_STRIDE];
+    bool * dest_rows[MORTON_STRIDE];
+    morton_rows(ctx->src, tx, ty, src_rows);
+    morton_rows(ctx->dest, tx, ty, dest_rows);
+
+    struct StepContext local = {
+        .src = src_rows + 1,
+        .dest = dest_rows + 1,
+        .width = tile.x_end - tile.x_begin,
+        .height = tile.y_end - tile.y_begin
+    };
+    struct Tile local_tile = {0, local.height, 0, local.width};
+
+    #if BLOCK_LOOKUP == TRUE
+        step_block_tile(&local, local_tile);
+    #else
+        step_tile(&local, local_tile);
+    #endif
+
+    if (stats_stream.file != NULL) {
+        count_tile_stats(local.src, local.dest, local_tile, tile.x_begin, tile.y_begin);
+    }
 
 }
 
@@ -318,21 +905,82 @@ int print_cells_to_file(bool ** cells, int iStep, int width, int height) {
 
 // -------------------------------------------------------------------------- //
 
-// Print the Cell Array to STDOUT using colors
-void print_cells(bool ** cells, int width, int height) {
+// Pack the Cells into Bits (Bit x of Row y is Bit x % 64 of Word x / 64,
+// with (width + 63) / 64 Words per Row), which is what the Views of the
+// Terminal and the GIF are made from.
+void pack_cells (bool ** cells, int width, int height, uint64_t * bits) {
+    const long words = (width + 63) / 64;
+    for (long iLauf = 0; iLauf < height; iLauf ++) {
+        uint64_t * row = bits + iLauf * words;
+        memset(row, 0, sizeof(uint64_t) * words);
+        for (long iLauf2 = 0; iLauf2 < width; iLauf2 ++) {
+            row[iLauf2 / 64] |= (uint64_t) cells[iLauf][iLauf2] << (iLauf2 % 64);
+        }
+    }
+}
+
+
+// Write the Generation into the GIF (--gif) and the Frame Stream (--frames),
+// which both take the packed Board.
+// Returns -1 if one of them could not be written.
+int record_cells (bool ** cells, int width, int height, int generation) {
+
+    if ((gif.file == NULL) && (frame_stream.file == NULL)) return 0;
+
+    uint64_t * bits = (gif.file != NULL) ? gif.bits : frame_stream.bits;
+    const long words = (width + 63) / 64;
+    pack_cells(cells, width, height, bits);
+
+    if ((gif.file != NULL) && (write_gif_frame(&gif, bits, words) < 0)) return -1;
+    if ((frame_stream.file != NULL) && (write_frame(&frame_stream, bits, words, generation) < 0)) {
+        return -1;
+    }
+
+    return 0;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Show the Board on the Terminal using colors.
+// Only the Cells which changed since the last Round are redrawn.
+// With --render-thread the Board is only handed to the Render Thread (if it
+// wants a new Frame, or for the last Round).
+// Returns -1 if the Terminal could not be written to.
+int print_cells(bool ** cells, int width, int height, int round, bool last) {
+
+    uint64_t * bits = renderer.bits;
+
+    if (options.render_thread) {
+        bits = render_snapshot(&render_thread, last);
+        if (bits == NULL) return 0;
+    } else if (!render_due(&renderer)) {
+        // Skip the Frame if its Time has not come yet (--render-fps)
+        return 0;
+    }
+
+    if (options.render_thread || (renderer.mode != RENDER_CELLS)) {
+        // The Snapshots and the scaled down Views are made from a packed Board
+        pack_cells(cells, width, height, bits);
+        if (options.render_thread) {
+            publish_snapshot(&render_thread, round);
+            return 0;
+        }
+        render_rows(&renderer, bits, renderer.words);
+        return render_frame(&renderer, round);
+    }
+
+    unsigned char * frame = renderer.current;
 
     for (long iLauf = 0; iLauf < height; iLauf ++) {
         for (long iLauf2 = 0; iLauf2 < width; iLauf2 ++) {
-            // Print a green 'a' when the Cell is alive
-            // Print a red 'd' when the Cell is dead
-            printf(
-                "\x1B[%dm %c",
-                cells[iLauf][iLauf2] ? 32 : 31,
-                cells[iLauf][iLauf2] ? 'a' : 'd'
-            );
+            // Show a green 'a' when the Cell is alive
+            // Show a red 'd' when the Cell is dead
+            *frame++ = render_cell(cells[iLauf][iLauf2], cells[iLauf][iLauf2] ? 'a' : 'd');
         }
-        printf("\n");
     }
+
+    return render_frame(&renderer, round);
 }
 
 // -------------------------------------------------------------------------- //
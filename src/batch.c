@@ -0,0 +1,599 @@
+
+// -------------------------------------------------------------------------- //
+// --- Explanation ---------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Batch Mode of the Packed Variant, which plays many small independent Boards
+// (e.g. random Soups for a Census) in a single Process:
+//
+//      ./game 16 16 0.5 1000 --batch soups.txt
+//
+// Every Line of the Batch File describes one Board:
+//
+//      <seed> [<width> <height> [<density> [<steps>]]]
+//
+// Missing Values are taken from the positional Arguments. Empty Lines and
+// Lines starting with '#' are skipped.
+//
+// The Boards are handed to the Threads of the Scheduler as Tiles of a single
+// Run (one Tile per Group of Boards), so Threads which got the quick Boards
+// steal the remaining ones from the others. A Board never touches any
+// Globals: it is filled by its own Random Generator (seeded with its Seed,
+// so the same Line always gives the same Soup) and played in Buffers which
+// belong to the Thread and are reused for all of its Boards.
+// A Board stops early once it has settled, i.e. once a Generation repeats
+// the one before (Period 1) or the one before that (Period 2).
+//
+// Small Boards waste most of the Bits of a Bitmap (a Board 16 Cells wide
+// only uses 16 Bits of every Word). So up to 64 Boards of the same Size are
+// interleaved into Lanes instead, where every Cell is a Word and Bit i of it
+// belongs to Board i:
+//
+//      Bitmap:  Word = 64 Cells of 1 Board     => Neighbours need Shifts
+//      Lanes:   Word = 1 Cell of 64 Boards     => Neighbours are the Words
+//                                                 around it
+//
+// All Boards of the Group are stepped at once by the Lane Kernel of the
+// Rule (see bitslice.c). A Board which settled or reached its Steps retires:
+// its Lane is frozen (keeps its last Generation) and the Group stops once
+// all of its Lanes retired. A Group only uses Lanes if that needs fewer
+// Words per Generation than playing its Boards one by one
+// (width < Boards * Words per Row).
+//
+// With --census the Objects left on every Board are counted as well (see
+// census.c).
+//
+// Once all Boards are done one CSV-Line per Board is written to STDOUT (in
+// the Order of the Batch File):
+//
+//      seed,width,height,density,steps,generations,population,period
+//
+// generations => Generations calculated until the Board settled (or steps)
+// population  => Alive Cells of the last Generation
+// period      => 1 or 2 if the Board settled, otherwise 0
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Interleave Boards of the same Size into Lanes (FALSE => every Board is
+// played on its own Bitmap)
+#ifndef BATCH_LANES
+    #define BATCH_LANES TRUE
+#endif
+
+#define LANES 64
+
+// One Board of the Batch
+struct BatchBoard {
+    unsigned long long seed;
+    int width;
+    int height;
+    double density;
+    int steps;
+    // Result
+    int generations;
+    long population;
+    int period;
+    // -1 if no Memory could be allocated for the Board
+    int error;
+};
+
+// Boards played by the same Tile (all of the same Size)
+struct BatchGroup {
+    struct BatchBoard ** boards;
+    int count;
+    // Played in Lanes (otherwise count is 1)
+    bool lanes;
+};
+
+// Buffers of a Thread, which grow to the biggest Board it gets
+struct BatchBuffers {
+    // The current, the next and the previous Generation
+    struct Bitmap bitmaps[3];
+    // Same for the Lanes (3 Boards of lane_size Words)
+    u64 * lanes;
+    size_t lane_size;
+    size_t lane_capacity;
+    // Objects found by the Thread (with --census)
+    struct Census census;
+};
+
+struct Batch {
+    struct BatchBoard * boards;
+    long count;
+    // Boards sorted by Size, so Boards of the same Size are next to each
+    // other, and the Groups made of them
+    struct BatchBoard ** order;
+    struct BatchGroup * groups;
+    long num_groups;
+    struct Kernel kernel;
+    // Count the Objects of the Boards (with --census)
+    bool census;
+    // One per Thread of the Scheduler
+    struct BatchBuffers * buffers;
+};
+
+// -------------------------------------------------------------------------- //
+
+int run_batch (const char * path, int width, int height, double density, int steps);
+int read_batch (struct Batch * batch, const char * path, int width, int height, double density, int steps);
+int group_batch (struct Batch * batch);
+void play_batch_group (void * ctx, struct Tile tile);
+void play_batch_board (struct Batch * batch, struct BatchBuffers * buffers, struct BatchBoard * b);
+void play_batch_lanes (struct Batch * batch, struct BatchBuffers * buffers, struct BatchGroup * g);
+void wrap_lanes (u64 * cells, long width, long height);
+void extract_lane (const u64 * cells, long width, long height, int lane, struct Bitmap * b);
+int finish_census (struct Batch * batch, int threads);
+static int reshape_lanes (struct BatchBuffers * buffers, int width, int height);
+static int compare_batch_boards (const void * a, const void * b);
+static bool equal_bitmaps (const struct Bitmap * a, const struct Bitmap * b);
+static long bitmap_population (const struct Bitmap * b);
+
+// -------------------------------------------------------------------------- //
+
+// Play all Boards of the Batch File and write their Results.
+// Returns -1 if the File is invalid or not all Boards could be played.
+int run_batch (const char * path, int width, int height, double density, int steps) {
+
+    struct Batch batch = {
+        .boards = NULL,
+        .count = 0,
+        .order = NULL,
+        .groups = NULL,
+        .num_groups = 0,
+        .kernel = select_kernel(&options.rule, false),
+        .census = options.census_path != NULL,
+        .buffers = NULL
+    };
+    if (read_batch(&batch, path, width, height, density, steps) < 0) {
+        free(batch.boards);
+        return -1;
+    }
+
+    printf("seed,width,height,density,steps,generations,population,period\n");
+    if (batch.count == 0) {
+        free(batch.boards);
+        return (batch.census && (finish_census(&batch, 0) < 0)) ? -1 : 0;
+    }
+
+    if (group_batch(&batch) < 0) {
+        printf("Could not allocate the Groups of the Batch\n");
+        free(batch.order);
+        free(batch.groups);
+        free(batch.boards);
+        return -1;
+    }
+
+    // Every Group is a Tile of 1x1 Cells
+    struct Scheduler pool;
+    if (init_scheduler_tiles(&pool, THREADS, batch.num_groups, 1, 1, 1) < 0) {
+        printf("Could not start the Scheduler\n");
+        free(batch.order);
+        free(batch.groups);
+        free(batch.boards);
+        return -1;
+    }
+    batch.buffers = calloc(pool.num_threads, sizeof(struct BatchBuffers));
+    if (batch.buffers == NULL) {
+        printf("Could not allocate the Boards of the Threads\n");
+        uninit_scheduler(&pool);
+        free(batch.order);
+        free(batch.groups);
+        free(batch.boards);
+        return -1;
+    }
+
+    run_tiles(&pool, play_batch_group, &batch);
+
+    int result = 0;
+    for (long iLauf = 0; iLauf < batch.count; iLauf ++) {
+        const struct BatchBoard * b = &batch.boards[iLauf];
+        if (b->error < 0) {
+            fprintf(stderr, "Could not allocate the Memory for Board %ld (%d x %d Cells)\n", iLauf, b->width, b->height);
+            result = -1;
+            continue;
+        }
+        printf("%llu,%d,%d,%g,%d,%d,%ld,%d\n",
+            b->seed, b->width, b->height, b->density, b->steps,
+            b->generations, b->population, b->period
+        );
+    }
+
+    if ((result == 0) && batch.census && (finish_census(&batch, pool.num_threads) < 0)) result = -1;
+
+    for (int iLauf = 0; iLauf < pool.num_threads; iLauf ++) {
+        for (int iLauf2 = 0; iLauf2 < 3; iLauf2 ++) {
+            uninit_bitmap(&batch.buffers[iLauf].bitmaps[iLauf2]);
+        }
+        free(batch.buffers[iLauf].lanes);
+        uninit_census(&batch.buffers[iLauf].census);
+    }
+    free(batch.buffers);
+    uninit_scheduler(&pool);
+    free(batch.order);
+    free(batch.groups);
+    free(batch.boards);
+
+    return result;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Read the Boards of the Batch File (see Explanation).
+// Prints what is wrong and returns -1 if the File is invalid.
+int read_batch (
+    struct Batch * batch, const char * path,
+    int width, int height, double density, int steps
+) {
+
+    FILE * file = fopen(path, "r");
+    if (file == NULL) {
+        printf("Could not open the Batch File \"%s\"\n", path);
+        return -1;
+    }
+
+    long capacity = 0;
+    long line_number = 0;
+    char line[256];
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line_number ++;
+
+        struct BatchBoard b = {
+            .width = width,
+            .height = height,
+            .density = density,
+            .steps = steps
+        };
+        char rest;
+        int fields = sscanf(line, "%llu %d %d %lf %d %c",
+            &b.seed, &b.width, &b.height, &b.density, &b.steps, &rest
+        );
+        // Skip empty Lines and Comments
+        if ((fields == EOF) || (line[strspn(line, " \t")] == '#')) continue;
+        if (
+            (fields < 1) || (fields == 2) || (fields > 5) ||
+            (b.width <= 0) || (b.height <= 0) ||
+            (b.density < 0) || (b.density > 1) || (b.steps < 0)
+        ) {
+            printf("Invalid Board in Line %ld of the Batch File \"%s\"\n", line_number, path);
+            fclose(file);
+            return -1;
+        }
+
+        if (batch->count == capacity) {
+            capacity = capacity ? (2 * capacity) : 64;
+            struct BatchBoard * boards = realloc(batch->boards, sizeof(struct BatchBoard) * capacity);
+            if (boards == NULL) {
+                printf("Could not allocate the Boards of the Batch\n");
+                fclose(file);
+                return -1;
+            }
+            batch->boards = boards;
+        }
+        batch->boards[batch->count ++] = b;
+    }
+
+    fclose(file);
+    return 0;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Sort the Boards by Size and split them into Groups (see Explanation).
+// Returns -1 if no Memory could be allocated.
+int group_batch (struct Batch * batch) {
+
+    batch->order = malloc(sizeof(struct BatchBoard *) * batch->count);
+    batch->groups = malloc(sizeof(struct BatchGroup) * batch->count);
+    if ((batch->order == NULL) || (batch->groups == NULL)) return -1;
+
+    for (long iLauf = 0; iLauf < batch->count; iLauf ++) {
+        batch->order[iLauf] = &batch->boards[iLauf];
+    }
+    qsort(batch->order, batch->count, sizeof(struct BatchBoard *), compare_batch_boards);
+
+    long begin = 0;
+    while (begin < batch->count) {
+        // Take up to 64 Boards of the same Size
+        const struct BatchBoard * first = batch->order[begin];
+        long end = begin + 1;
+        while (
+            (end < batch->count) && ((end - begin) < LANES) &&
+            (compare_batch_boards(&batch->order[begin], &batch->order[end]) == 0)
+        ) {
+            end ++;
+        }
+
+        const long words = (first->width + 63) / 64;
+        if (BATCH_LANES && ((end - begin) > 1) && (first->width < ((end - begin) * words))) {
+            struct BatchGroup * g = &batch->groups[batch->num_groups ++];
+            g->boards = &batch->order[begin];
+            g->count = end - begin;
+            g->lanes = true;
+        } else {
+            for (long iLauf = begin; iLauf < end; iLauf ++) {
+                struct BatchGroup * g = &batch->groups[batch->num_groups ++];
+                g->boards = &batch->order[iLauf];
+                g->count = 1;
+                g->lanes = false;
+            }
+        }
+        begin = end;
+    }
+
+    return 0;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Play the Group with the Index tile.x_begin (called by the Scheduler)
+void play_batch_group (void * ctx, struct Tile tile) {
+    struct Batch * batch = ctx;
+    struct BatchGroup * g = &batch->groups[tile.x_begin];
+    struct BatchBuffers * buffers = &batch->buffers[scheduler_thread_index()];
+    if (g->lanes) {
+        play_batch_lanes(batch, buffers, g);
+    } else {
+        play_batch_board(batch, buffers, g->boards[0]);
+    }
+}
+
+// Play a single Board on a Bitmap until it settles or all of its Steps are
+// done
+void play_batch_board (struct Batch * batch, struct BatchBuffers * buffers, struct BatchBoard * b) {
+
+    for (int iLauf = 0; iLauf < 3; iLauf ++) {
+        if (reshape_bitmap(&buffers->bitmaps[iLauf], b->width, b->height) < 0) {
+            b->error = -1;
+            return;
+        }
+    }
+    struct Bitmap * curr = &buffers->bitmaps[0];
+    struct Bitmap * next = &buffers->bitmaps[1];
+    struct Bitmap * prev = &buffers->bitmaps[2];
+    struct Bitmap * temp;
+
+    fill_bitmap(curr, b->density, b->seed);
+
+    b->generations = 0;
+    b->period = 0;
+    while (b->generations < b->steps) {
+        exchange_bitmap_halo(curr);
+        run_kernel(&batch->kernel, curr, next, 0, b->height, 0, next->words, NULL);
+        b->generations ++;
+
+        if (equal_bitmaps(next, curr)) {
+            b->period = 1;
+        } else if ((b->generations > 1) && equal_bitmaps(next, prev)) {
+            b->period = 2;
+        }
+
+        // Rotate the Generations
+        temp = prev;
+        prev = curr;
+        curr = next;
+        next = temp;
+
+        if (b->period != 0) break;
+    }
+
+    b->population = bitmap_population(curr);
+
+    if (batch->census && (census_board(&buffers->census, curr, &batch->kernel) < 0)) b->error = -1;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Play all Boards of the Group at once in Lanes until every one of them
+// settled or did all of its Steps
+void play_batch_lanes (struct Batch * batch, struct BatchBuffers * buffers, struct BatchGroup * g) {
+
+    const long width = g->boards[0]->width;
+    const long height = g->boards[0]->height;
+    const long stride = width + 2;
+
+    if (reshape_lanes(buffers, width, height) < 0) {
+        for (int iLauf = 0; iLauf < g->count; iLauf ++) g->boards[iLauf]->error = -1;
+        return;
+    }
+    // Point to Cell (0, 0) of each Generation
+    u64 * curr = buffers->lanes + stride + 1;
+    u64 * next = curr + buffers->lane_size;
+    u64 * prev = next + buffers->lane_size;
+    u64 * temp;
+
+    // Fill Lane i with the same Soup as fill_bitmap
+    u64 active = 0;
+    for (int iLauf = 0; iLauf < g->count; iLauf ++) {
+        struct BatchBoard * b = g->boards[iLauf];
+        u64 state = b->seed;
+        const u64 threshold = b->density * (double) (1ULL << 53);
+        for (long iLauf2 = 0; iLauf2 < height; iLauf2 ++) {
+            for (long iLauf3 = 0; iLauf3 < width; iLauf3 ++) {
+                if ((next_random(&state) >> 11) < threshold) {
+                    curr[iLauf2 * stride + iLauf3] |= 1ULL << iLauf;
+                }
+            }
+        }
+        b->generations = 0;
+        b->period = 0;
+        if (b->steps > 0) active |= 1ULL << iLauf;
+    }
+
+    int generation = 0;
+    while (active != 0) {
+        #if TOPOLOGY == TORUS
+            wrap_lanes(curr, width, height);
+        #endif
+        run_lane_kernel(&batch->kernel, curr, next, width, height);
+        generation ++;
+
+        // Freeze the retired Lanes and find the Lanes which changed since
+        // the last and the Generation before that
+        u64 changed = 0;
+        u64 changed_twice = 0;
+        for (long iLauf = 0; iLauf < height; iLauf ++) {
+            u64 * out = next + iLauf * stride;
+            const u64 * row = curr + iLauf * stride;
+            const u64 * old = prev + iLauf * stride;
+            for (long iLauf2 = 0; iLauf2 < width; iLauf2 ++) {
+                out[iLauf2] = (out[iLauf2] & active) | (row[iLauf2] & ~active);
+                changed |= out[iLauf2] ^ row[iLauf2];
+                changed_twice |= out[iLauf2] ^ old[iLauf2];
+            }
+        }
+
+        // Retire the Boards which settled or did all of their Steps
+        for (u64 lanes = active; lanes != 0; lanes &= lanes - 1) {
+            const int lane = __builtin_ctzll(lanes);
+            struct BatchBoard * b = g->boards[lane];
+            b->generations = generation;
+            if (!((changed >> lane) & 1)) {
+                b->period = 1;
+            } else if ((generation > 1) && !((changed_twice >> lane) & 1)) {
+                b->period = 2;
+            } else if (generation < b->steps) {
+                continue;
+            }
+            active &= ~(1ULL << lane);
+        }
+
+        // Rotate the Generations
+        temp = prev;
+        prev = curr;
+        curr = next;
+        next = temp;
+    }
+
+    // Count the Cells of every Lane
+    for (int iLauf = 0; iLauf < g->count; iLauf ++) g->boards[iLauf]->population = 0;
+    for (long iLauf = 0; iLauf < height; iLauf ++) {
+        for (long iLauf2 = 0; iLauf2 < width; iLauf2 ++) {
+            for (u64 cell = curr[iLauf * stride + iLauf2]; cell != 0; cell &= cell - 1) {
+                g->boards[__builtin_ctzll(cell)]->population ++;
+            }
+        }
+    }
+
+    // Take the Boards out of their Lanes for the Census
+    for (int iLauf = 0; batch->census && (iLauf < g->count); iLauf ++) {
+        struct Bitmap * board = &buffers->bitmaps[0];
+        if (reshape_bitmap(board, width, height) < 0) {
+            g->boards[iLauf]->error = -1;
+            continue;
+        }
+        extract_lane(curr, width, height, iLauf, board);
+        if (census_board(&buffers->census, board, &batch->kernel) < 0) g->boards[iLauf]->error = -1;
+    }
+
+}
+
+// Copy Board lane of the Lanes into the Bitmap (of the same Size)
+void extract_lane (const u64 * cells, long width, long height, int lane, struct Bitmap * b) {
+    const long stride = width + 2;
+    for (long iLauf = 0; iLauf < height; iLauf ++) {
+        u64 * row = bitmap_row(b, iLauf);
+        for (long iLauf2 = 0; iLauf2 < width; iLauf2 ++) {
+            row[iLauf2 / 64] |= ((cells[iLauf * stride + iLauf2] >> lane) & 1) << (iLauf2 % 64);
+        }
+    }
+}
+
+// Make the Lanes of the Buffers big enough for 3 Generations of the Size and
+// kill all of their Cells (including the Ghost Cells).
+// Returns -1 if no Memory could be allocated.
+static int reshape_lanes (struct BatchBuffers * buffers, int width, int height) {
+    buffers->lane_size = (size_t) (width + 2) * (height + 2);
+    if ((3 * buffers->lane_size) > buffers->lane_capacity) {
+        u64 * lanes = realloc(buffers->lanes, sizeof(u64) * 3 * buffers->lane_size);
+        if (lanes == NULL) return -1;
+        buffers->lanes = lanes;
+        buffers->lane_capacity = 3 * buffers->lane_size;
+    }
+    memset(buffers->lanes, 0, sizeof(u64) * 3 * buffers->lane_size);
+    return 0;
+}
+
+// Copy the Cells on the Edges of the Lanes to the Ghost Cells on the opposite
+// Side (like exchange_bitmap_halo)
+void wrap_lanes (u64 * cells, long width, long height) {
+    const long stride = width + 2;
+    for (long iLauf = 0; iLauf < height; iLauf ++) {
+        u64 * row = cells + iLauf * stride;
+        row[-1] = row[width - 1];
+        row[width] = row[0];
+    }
+    memcpy(cells - stride - 1, cells + (height - 1) * stride - 1, sizeof(u64) * stride);
+    memcpy(cells + height * stride - 1, cells - 1, sizeof(u64) * stride);
+}
+
+// -------------------------------------------------------------------------- //
+
+// Merge the Objects found by the Threads and write them to the Census File.
+// Returns -1 if the File could not be written.
+int finish_census (struct Batch * batch, int threads) {
+
+    struct CensusTable total = {
+        .objects = NULL,
+        .size = 0,
+        .capacity = 0
+    };
+    for (int iLauf = 0; iLauf < threads; iLauf ++) {
+        if (merge_census(&total, &batch->buffers[iLauf].census) < 0) {
+            printf("Could not allocate the Census\n");
+            uninit_census_table(&total, true);
+            return -1;
+        }
+    }
+
+    int result = write_census(options.census_path, &total);
+    if (result < 0) printf("Could not write the Census \"%s\"\n", options.census_path);
+    uninit_census_table(&total, true);
+
+    return result;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Sort by Width and then by Height
+static int compare_batch_boards (const void * a, const void * b) {
+    const struct BatchBoard * self = *(struct BatchBoard * const *) a;
+    const struct BatchBoard * other = *(struct BatchBoard * const *) b;
+    if (self->width != other->width) return (self->width < other->width) ? -1 : 1;
+    if (self->height != other->height) return (self->height < other->height) ? -1 : 1;
+    return 0;
+}
+
+// Compare the Cells of two Bitmaps of the same Size
+// (on a Torus the Padding can hold a Copy of the first Cell, so it is ignored)
+static bool equal_bitmaps (const struct Bitmap * a, const struct Bitmap * b) {
+    const long last = a->words - 1;
+    for (long iLauf = 0; iLauf < a->height; iLauf ++) {
+        const u64 * row_a = bitmap_row(a, iLauf);
+        const u64 * row_b = bitmap_row(b, iLauf);
+        if (memcmp(row_a, row_b, sizeof(u64) * last) != 0) return false;
+        if (((row_a[last] ^ row_b[last]) & a->tail_mask) != 0) return false;
+    }
+    return true;
+}
+
+static long bitmap_population (const struct Bitmap * b) {
+    long population = 0;
+    for (long iLauf = 0; iLauf < b->height; iLauf ++) {
+        const u64 * row = bitmap_row(b, iLauf);
+        for (long iLauf2 = 0; iLauf2 < b->words; iLauf2 ++) {
+            const u64 mask = (iLauf2 == (b->words - 1)) ? b->tail_mask : ~0ULL;
+            population += __builtin_popcountll(row[iLauf2] & mask);
+        }
+    }
+    return population;
+}
+
+// -------------------------------------------------------------------------- //
@@ -0,0 +1,205 @@
+
+// -------------------------------------------------------------------------- //
+// --- Explanation ---------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Bit-packed Game Board: every Cell is a single Bit, 64 Cells share a Word.
+// Cell x of a Row is Bit (x % 64) of Word (x / 64).
+//
+// Like the Boards of the other Grid-Variants the Bitmap has a Ring of Ghost
+// Cells around it. Every Row has one Guard Word on each Side and there is a
+// Ghost Row above and below the Board:
+//
+//            -1     0     1   ...  words-1  words
+//          ------------------------------------
+//      -1  | G  |      Ghost Row           | G  |
+//       0  | G  |  Row 0                   | G  |
+//      ..  | .. |  ..                      | .. |
+//  height  | G  |      Ghost Row           | G  |
+//          ------------------------------------
+//
+// The Bits of the last Word which lie beyond the Width (the Padding) are
+// always kept at 0 (except for the one right next to the Board when the
+// Board is a Torus, see exchange_bitmap_halo).
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+#define u64 uint64_t
+
+struct Bitmap {
+    int width;
+    int height;
+    // Number of Words containing Cells in each Row
+    long words;
+    // Distance between two Rows in Words (including the Guard Words)
+    long stride;
+    // Mask of the valid Bits in the last Word of each Row
+    u64 tail_mask;
+    // Points to the first Word of Row 0
+    u64 * cells;
+    // Start of the allocated Memory and its Size in Words
+    u64 * memory;
+    size_t capacity;
+};
+
+// -------------------------------------------------------------------------- //
+
+int init_bitmap (struct Bitmap * b, int width, int height);
+void uninit_bitmap (struct Bitmap * b);
+int reshape_bitmap (struct Bitmap * b, int width, int height);
+static inline u64 * bitmap_row (const struct Bitmap * b, long y);
+bool get_bit (const struct Bitmap * b, long x, long y);
+void set_bit (struct Bitmap * b, long x, long y, bool alive);
+void wrap_bitmap_row (struct Bitmap * b, long y);
+void exchange_bitmap_halo (struct Bitmap * b);
+void wrap_bitmap_halo (struct Bitmap * b);
+void fill_bitmap (struct Bitmap * b, double density, u64 seed);
+static inline u64 next_random (u64 * state);
+
+// -------------------------------------------------------------------------- //
+
+// Allocate an empty Bitmap with the given Size.
+// Returns -1 if the Size is invalid or no Memory could be allocated.
+int init_bitmap (struct Bitmap * b, int width, int height) {
+
+    if ((b == NULL) || (width <= 0) || (height <= 0)) return -1;
+
+    b->width = width;
+    b->height = height;
+    b->words = (width + 63) / 64;
+    b->stride = b->words + 2;
+    b->tail_mask = (width % 64) ? ((1ULL << (width % 64)) - 1) : ~0ULL;
+
+    // All Cells (including the Ghost Cells) start out dead
+    b->capacity = (height + 2) * b->stride;
+    b->memory = calloc(b->capacity, sizeof(u64));
+    if (b->memory == NULL) return -1;
+
+    b->cells = b->memory + b->stride + 1;
+
+    return 0;
+
+}
+
+void uninit_bitmap (struct Bitmap * b) {
+    if (b == NULL) return;
+    free(b->memory);
+    b->memory = NULL;
+    b->cells = NULL;
+    b->capacity = 0;
+}
+
+// Change the Size of a Bitmap (allocated or zeroed) and kill all its Cells.
+// The Memory is only reallocated if the Bitmap grows, so the same Bitmap can
+// be reused for many Boards.
+// Returns -1 if the Size is invalid or no Memory could be allocated.
+int reshape_bitmap (struct Bitmap * b, int width, int height) {
+
+    if ((b == NULL) || (width <= 0) || (height <= 0)) return -1;
+
+    const long words = (width + 63) / 64;
+    const size_t needed = (height + 2) * (words + 2);
+    if (needed > b->capacity) {
+        u64 * memory = realloc(b->memory, sizeof(u64) * needed);
+        if (memory == NULL) return -1;
+        b->memory = memory;
+        b->capacity = needed;
+    }
+
+    b->width = width;
+    b->height = height;
+    b->words = words;
+    b->stride = words + 2;
+    b->tail_mask = (width % 64) ? ((1ULL << (width % 64)) - 1) : ~0ULL;
+    b->cells = b->memory + b->stride + 1;
+    memset(b->memory, 0, sizeof(u64) * needed);
+
+    return 0;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Get the first Word of Row y (y = -1 and y = height are the Ghost Rows)
+static inline u64 * bitmap_row (const struct Bitmap * b, long y) {
+    return b->cells + y * b->stride;
+}
+
+bool get_bit (const struct Bitmap * b, long x, long y) {
+    return (bitmap_row(b, y)[x / 64] >> (x % 64)) & 1;
+}
+
+void set_bit (struct Bitmap * b, long x, long y, bool alive) {
+    u64 * word = &bitmap_row(b, y)[x / 64];
+    if (alive) {
+        *word |= (1ULL << (x % 64));
+    } else {
+        *word &= ~(1ULL << (x % 64));
+    }
+}
+
+// -------------------------------------------------------------------------- //
+
+// Copy the first and last Cell of Row y next to the opposite Edge of the Row
+// (see exchange_bitmap_halo)
+void wrap_bitmap_row (struct Bitmap * b, long y) {
+    const int last = b->width - 1;
+    u64 * row = bitmap_row(b, y);
+    row[-1] = ((row[last / 64] >> (last % 64)) & 1) << 63;
+    row[b->words] = 0;
+    row[b->width / 64] |= (row[0] & 1) << (b->width % 64);
+}
+
+// Fill the Ghost Cells around the Board before a Generation is calculated.
+// With Dead Edges nothing has to be done, because the Ghost Cells are never
+// written and stay dead. On a Torus the Cells on the opposite Edges are
+// copied next to the Board:
+//      - Bit 63 of the left Guard Word gets the last Cell of the Row
+//      - The Bit right after the last Cell gets the first Cell of the Row
+//        (this is either a Padding Bit or Bit 0 of the right Guard Word)
+//      - The Ghost Rows get a Copy of the last and first Row
+void exchange_bitmap_halo (struct Bitmap * b) {
+    #if TOPOLOGY == TORUS
+        wrap_bitmap_halo(b);
+    #else
+        UNUSED(b);
+    #endif
+}
+
+// Fill the Ghost Cells of a Torus (also used by the Tests, which check both
+// Topologies)
+void wrap_bitmap_halo (struct Bitmap * b) {
+    for (long iLauf = 0; iLauf < b->height; iLauf ++) {
+        wrap_bitmap_row(b, iLauf);
+    }
+    memcpy(bitmap_row(b, -1) - 1, bitmap_row(b, b->height - 1) - 1, sizeof(u64) * b->stride);
+    memcpy(bitmap_row(b, b->height) - 1, bitmap_row(b, 0) - 1, sizeof(u64) * b->stride);
+}
+
+// -------------------------------------------------------------------------- //
+
+// Fill the (empty) Bitmap with a random Soup, where every Cell is alive with
+// the Probability density. The same Seed always gives the same Soup.
+void fill_bitmap (struct Bitmap * b, double density, u64 seed) {
+    // Compare the upper 53 Bits of the Random Numbers, so a Density of 1
+    // makes every Cell alive
+    u64 state = seed;
+    const u64 threshold = density * (double) (1ULL << 53);
+    for (long iLauf = 0; iLauf < b->height; iLauf ++) {
+        for (long iLauf2 = 0; iLauf2 < b->width; iLauf2 ++) {
+            if ((next_random(&state) >> 11) < threshold) set_bit(b, iLauf2, iLauf, true);
+        }
+    }
+}
+
+// SplitMix64 => Every Seed (even 0) gives a good Sequence
+static inline u64 next_random (u64 * state) {
+    u64 z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// -------------------------------------------------------------------------- //
@@ -0,0 +1,334 @@
+
+// -------------------------------------------------------------------------- //
+// --- Explanation ---------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Bit-sliced Kernels for the Packed Variant, which calculate the next State of
+// 64 Cells at once using only Boolean Operations on Words.
+//
+// 1. For every Word the 8 Neighbours of each Cell are shifted into place, so
+//    Bit b of each of the 8 Words is one Neighbour of the Cell at Bit b.
+// 2. A Network of Full-Adders sums them up into 4 Bit-Planes s0 - s3, so the
+//    Neighbour Count of the Cell at Bit b is (s3 s2 s1 s0) at Bit b.
+// 3. The Rule turns the Planes into the next State:
+//      alive' = (~alive & (Count in Birth)) | (alive & (Count in Survive))
+//    where (Count == n) is an AND of the 4 Planes (or their Inverse).
+//
+// Step 3 is written for Birth/Survive-Masks which are known at Compile-Time.
+// For every Rule in SPECIALISED_RULES a Kernel is generated in which the
+// Compiler folds the Masks away, leaving only the Terms that Rule needs
+// (e.g. B3/S23 => Count == 3 | (alive & Count == 2)).
+// All other Rules given with --rule use the generic Kernel, which evaluates
+// the Masks at Run-Time. Every Kernel takes the Masks as Arguments (the
+// specialised ones ignore them), so select_kernel returns them together with
+// the Kernel in a struct Kernel and Boards with different Rules can be
+// stepped at the same Time.
+//
+// Every Kernel also exists with Statistics (see stats.c), which counts the
+// Cells of each finished Row using popcount. In the Kernels without them the
+// Counting is folded away as well, so they stay as fast as before.
+//
+// The Lane Kernels use the same Network for a different Layout, in which
+// every Word is a single Cell of 64 different Boards (Bit i belongs to Board
+// i, see batch.c). The Neighbours are then simply the Words around it, so
+// nothing has to be shifted and all 64 Boards are stepped at once.
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Rules which get their own specialised Kernel
+// RULE(Name, Birth-Mask, Survive-Mask) => Bit n is set if n Neighbours
+// cause a Birth/let a Cell survive.
+#ifndef SPECIALISED_RULES
+    #define SPECIALISED_RULES(RULE) \
+        RULE(conway,    0x008, 0x00C)   /* B3/S23       */ \
+        RULE(highlife,  0x048, 0x00C)   /* B36/S23      */ \
+        RULE(day_night, 0x1C8, 0x1D8)   /* B3678/S34678 */
+#endif
+
+// Build the Kernels with Statistics (needs stats.c). The Library (gol.c)
+// does not count anything, so it leaves them out.
+#ifndef BITSLICE_STATS
+    #define BITSLICE_STATS TRUE
+#endif
+
+struct Stats;
+
+// Forces the Compiler to inline the Kernel Template into the generated
+// Kernels even without -O2, otherwise the Masks could not be folded away.
+#define ALWAYS_INLINE inline __attribute__((always_inline))
+
+// Calculates the Rows [y_begin, y_end) and Words [w_begin, w_end) of dest
+// (and adds their Statistics to stats if the Kernel counts them)
+typedef void (* BitsliceKernel)(
+    const struct Bitmap * src, struct Bitmap * dest,
+    long y_begin, long y_end, long w_begin, long w_end,
+    uint16_t birth, uint16_t survive, struct Stats * stats
+);
+
+// Calculates the next Generation of all Lanes of a Board of width x height
+// Words (src and dest point to the Word of Cell (0, 0), see batch.c)
+typedef void (* LaneKernel)(
+    const u64 * src, u64 * dest, long width, long height,
+    uint16_t birth, uint16_t survive
+);
+
+// The Kernels of a Rule and the Masks they are called with
+struct Kernel {
+    BitsliceKernel step;
+    LaneKernel lanes;
+    uint16_t birth;
+    uint16_t survive;
+};
+
+// -------------------------------------------------------------------------- //
+
+struct Kernel select_kernel (const struct Rule * rule, bool with_stats);
+static inline void run_kernel (const struct Kernel * k, const struct Bitmap * src, struct Bitmap * dest, long y_begin, long y_end, long w_begin, long w_end, struct Stats * stats);
+static inline void run_lane_kernel (const struct Kernel * k, const u64 * src, u64 * dest, long width, long height);
+static ALWAYS_INLINE u64 apply_rule (u64 alive, u64 s0, u64 s1, u64 s2, u64 s3, uint16_t birth, uint16_t survive);
+static ALWAYS_INLINE u64 bitslice_cells (u64 a0, u64 a1, u64 a2, u64 m0, u64 alive, u64 m2, u64 b0, u64 b1, u64 b2, uint16_t birth, uint16_t survive);
+static ALWAYS_INLINE void bitslice_rows (const struct Bitmap * src, struct Bitmap * dest, long y_begin, long y_end, long w_begin, long w_end, uint16_t birth, uint16_t survive, struct Stats * stats);
+static ALWAYS_INLINE void lane_rows (const u64 * src, u64 * dest, long width, long height, uint16_t birth, uint16_t survive);
+
+// -------------------------------------------------------------------------- //
+
+// All Cells whose Neighbour Count is n, in the Form of an AND of the Planes
+#define COUNT_IS(n, s0, s1, s2, s3) ( \
+    (((n) & 1) ? (s0) : ~(s0)) & (((n) & 2) ? (s1) : ~(s1)) & \
+    (((n) & 4) ? (s2) : ~(s2)) & (((n) & 8) ? (s3) : ~(s3)) \
+)
+
+// A Word of all Ones if the Neighbour Count n is set in the Mask, otherwise 0
+#define IF_COUNT(mask, n) (0 - (u64) CHECK_RULE_BIT(mask, n))
+
+// The next State of 64 Cells given their Neighbour Count Planes
+static ALWAYS_INLINE u64 apply_rule (
+    u64 alive, u64 s0, u64 s1, u64 s2, u64 s3, uint16_t birth, uint16_t survive
+) {
+    u64 born = 0;
+    u64 survives = 0;
+
+    // With constant Masks every Term either disappears or is reduced to
+    // COUNT_IS, which the Compiler then merges with the others.
+    #define RULE_TERM(n) \
+        born |= IF_COUNT(birth, n) & COUNT_IS(n, s0, s1, s2, s3); \
+        survives |= IF_COUNT(survive, n) & COUNT_IS(n, s0, s1, s2, s3);
+    RULE_TERM(0) RULE_TERM(1) RULE_TERM(2)
+    RULE_TERM(3) RULE_TERM(4) RULE_TERM(5)
+    RULE_TERM(6) RULE_TERM(7) RULE_TERM(8)
+    #undef RULE_TERM
+
+    return (~alive & born) | (alive & survives);
+}
+
+// The next State of the Cells at the Bits of alive given their 8 Neighbours
+// (a = above, m = same Row, b = below; 0 = left, 1 = middle, 2 = right)
+static ALWAYS_INLINE u64 bitslice_cells (
+    u64 a0, u64 a1, u64 a2, u64 m0, u64 alive, u64 m2, u64 b0, u64 b1, u64 b2,
+    uint16_t birth, uint16_t survive
+) {
+    // Sum of each Row (0 - 3 for the upper/lower, 0 - 2 for the middle Row)
+    // as 2-Bit Numbers
+    u64 as0 = a0 ^ a1 ^ a2;
+    u64 as1 = (a0 & a1) | (a2 & (a0 ^ a1));
+    u64 ms0 = m0 ^ m2;
+    u64 ms1 = m0 & m2;
+    u64 bs0 = b0 ^ b1 ^ b2;
+    u64 bs1 = (b0 & b1) | (b2 & (b0 ^ b1));
+
+    // Add up the 3 Row-Sums
+    u64 s0 = as0 ^ ms0 ^ bs0;
+    u64 c0 = (as0 & ms0) | (bs0 & (as0 ^ ms0));
+    // Bit 1 is the Sum of as1, ms1, bs1 and c0
+    u64 x = as1 ^ ms1, xc = as1 & ms1;
+    u64 y = bs1 ^ c0, yc = bs1 & c0;
+    u64 s1 = x ^ y;
+    // At most 2 of xc, yc and (x & y) can be set at the same Time
+    // (xc excludes x and yc excludes y)
+    u64 s2 = xc ^ yc ^ (x & y);
+    u64 s3 = xc & yc;
+
+    return apply_rule(alive, s0, s1, s2, s3, birth, survive);
+}
+
+// -------------------------------------------------------------------------- //
+
+// Kernel Template shared by all Kernels
+static ALWAYS_INLINE void bitslice_rows (
+    const struct Bitmap * src, struct Bitmap * dest,
+    long y_begin, long y_end, long w_begin, long w_end,
+    uint16_t birth, uint16_t survive, struct Stats * stats
+) {
+
+    for (long iLauf = y_begin; iLauf < y_end; iLauf ++) {
+        const u64 * above = bitmap_row(src, iLauf - 1);
+        const u64 * row = bitmap_row(src, iLauf);
+        const u64 * below = bitmap_row(src, iLauf + 1);
+        u64 * out = bitmap_row(dest, iLauf);
+
+        for (long iLauf2 = w_begin; iLauf2 < w_end; iLauf2 ++) {
+            // Neighbours to the left (x-1) and right (x+1) moved to the Bit
+            // of the Cell, taking the Bit from the neighbouring Word.
+            #define LEFT(r) (((r)[iLauf2] << 1) | ((r)[iLauf2-1] >> 63))
+            #define RIGHT(r) (((r)[iLauf2] >> 1) | ((r)[iLauf2+1] << 63))
+
+            u64 a0 = LEFT(above), a1 = above[iLauf2], a2 = RIGHT(above);
+            u64 m0 = LEFT(row), m2 = RIGHT(row);
+            u64 b0 = LEFT(below), b1 = below[iLauf2], b2 = RIGHT(below);
+
+            #undef LEFT
+            #undef RIGHT
+
+            out[iLauf2] = bitslice_cells(
+                a0, a1, a2, m0, row[iLauf2], m2, b0, b1, b2, birth, survive
+            );
+        }
+
+        // Keep the Padding behind the last Cell dead
+        if (w_end == dest->words) out[w_end - 1] &= dest->tail_mask;
+
+        // On a Torus the Padding of src can hold a Copy of the first Cell
+        #if BITSLICE_STATS == TRUE
+            if (stats != NULL) {
+                count_words(
+                    stats, row, out, iLauf, w_begin, w_end,
+                    (w_end == src->words) ? src->tail_mask : ~0ULL
+                );
+            }
+        #else
+            UNUSED(stats);
+        #endif
+    }
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Template of the Lane Kernels
+// Row y starts at src + y * (width + 2), the Ghost Cells around the Board
+// included.
+static ALWAYS_INLINE void lane_rows (
+    const u64 * src, u64 * dest, long width, long height,
+    uint16_t birth, uint16_t survive
+) {
+    const long stride = width + 2;
+    for (long iLauf = 0; iLauf < height; iLauf ++) {
+        const u64 * above = src + (iLauf - 1) * stride;
+        const u64 * row = src + iLauf * stride;
+        const u64 * below = src + (iLauf + 1) * stride;
+        u64 * out = dest + iLauf * stride;
+        for (long iLauf2 = 0; iLauf2 < width; iLauf2 ++) {
+            out[iLauf2] = bitslice_cells(
+                above[iLauf2-1], above[iLauf2], above[iLauf2+1],
+                row[iLauf2-1], row[iLauf2], row[iLauf2+1],
+                below[iLauf2-1], below[iLauf2], below[iLauf2+1],
+                birth, survive
+            );
+        }
+    }
+}
+
+// -------------------------------------------------------------------------- //
+
+// Generate two Kernels (without and with Statistics) and a Lane Kernel for
+// every specialised Rule, which use their own Masks instead of the given ones
+#define DEFINE_KERNEL(name, B, S) \
+    void step_##name ( \
+        const struct Bitmap * src, struct Bitmap * dest, \
+        long y_begin, long y_end, long w_begin, long w_end, \
+        uint16_t birth, uint16_t survive, struct Stats * stats \
+    ) { \
+        UNUSED(birth); \
+        UNUSED(survive); \
+        UNUSED(stats); \
+        bitslice_rows(src, dest, y_begin, y_end, w_begin, w_end, B, S, NULL); \
+    } \
+    void step_##name##_stats ( \
+        const struct Bitmap * src, struct Bitmap * dest, \
+        long y_begin, long y_end, long w_begin, long w_end, \
+        uint16_t birth, uint16_t survive, struct Stats * stats \
+    ) { \
+        UNUSED(birth); \
+        UNUSED(survive); \
+        bitslice_rows(src, dest, y_begin, y_end, w_begin, w_end, B, S, stats); \
+    } \
+    void lanes_##name ( \
+        const u64 * src, u64 * dest, long width, long height, \
+        uint16_t birth, uint16_t survive \
+    ) { \
+        UNUSED(birth); \
+        UNUSED(survive); \
+        lane_rows(src, dest, width, height, B, S); \
+    }
+SPECIALISED_RULES(DEFINE_KERNEL)
+#undef DEFINE_KERNEL
+
+void step_generic (
+    const struct Bitmap * src, struct Bitmap * dest,
+    long y_begin, long y_end, long w_begin, long w_end,
+    uint16_t birth, uint16_t survive, struct Stats * stats
+) {
+    UNUSED(stats);
+    bitslice_rows(src, dest, y_begin, y_end, w_begin, w_end, birth, survive, NULL);
+}
+
+void step_generic_stats (
+    const struct Bitmap * src, struct Bitmap * dest,
+    long y_begin, long y_end, long w_begin, long w_end,
+    uint16_t birth, uint16_t survive, struct Stats * stats
+) {
+    bitslice_rows(src, dest, y_begin, y_end, w_begin, w_end, birth, survive, stats);
+}
+
+void lanes_generic (
+    const u64 * src, u64 * dest, long width, long height,
+    uint16_t birth, uint16_t survive
+) {
+    lane_rows(src, dest, width, height, birth, survive);
+}
+
+// -------------------------------------------------------------------------- //
+
+// Get the Kernels for the Rule, which are the specialised ones if there are
+// any. The Kernel keeps the Masks itself, so any Number of Rules can be used
+// at the same Time.
+struct Kernel select_kernel (const struct Rule * rule, bool with_stats) {
+
+    struct Kernel kernel = {
+        .step = with_stats ? step_generic_stats : step_generic,
+        .lanes = lanes_generic,
+        .birth = rule->birth,
+        .survive = rule->survive
+    };
+
+    #define MATCH_KERNEL(name, B, S) \
+        if ((rule->birth == (B)) && (rule->survive == (S))) { \
+            kernel.step = with_stats ? step_##name##_stats : step_##name; \
+            kernel.lanes = lanes_##name; \
+        }
+    SPECIALISED_RULES(MATCH_KERNEL)
+    #undef MATCH_KERNEL
+
+    return kernel;
+
+}
+
+// Calculate the Rows [y_begin, y_end) and Words [w_begin, w_end) of dest
+// with the Kernel
+static inline void run_kernel (
+    const struct Kernel * k, const struct Bitmap * src, struct Bitmap * dest,
+    long y_begin, long y_end, long w_begin, long w_end, struct Stats * stats
+) {
+    k->step(src, dest, y_begin, y_end, w_begin, w_end, k->birth, k->survive, stats);
+}
+
+// Calculate the next Generation of all Lanes with the Lane Kernel
+static inline void run_lane_kernel (
+    const struct Kernel * k, const u64 * src, u64 * dest, long width, long height
+) {
+    k->lanes(src, dest, width, height, k->birth, k->survive);
+}
+
+// -------------------------------------------------------------------------- //
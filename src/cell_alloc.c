@@ -28,6 +28,11 @@
 //                                 Chunk Pointers
 //                                 BEWARE: This Field needs to be able to
 //                                 store a Pointer in it (long)
+//      => (Optional) COUNT_NEW_CHUNK() = Called whenever a Chunk is
+//                                 allocated (e.g. for Profiling)
+//      => (Optional) TRACE(category, format, ...) = Records Chunk
+//                                 Allocations, Redirections, ... (see
+//                                 trace.c for the Categories)
 
 // -------------------------------------------------------------------------- //
 // -------------------------------------------------------------------------- //
@@ -39,26 +44,9 @@
 // Deallocate Chunks once they contain no more data.
 #define DEALLOCATE_UNUSED_CHUNKS TRUE
 
-// Debug Options
-#ifndef DEBUG
-    #define DEBUG FALSE
-#endif
-#if DEBUG == TRUE
-    #ifndef OUTPUT_REDIRECTION
-        #define OUTPUT_REDIRECTION FALSE
-    #endif
-    #ifndef OUTPUT_CELL_ASSIGN
-        #define OUTPUT_CELL_ASSIGN FALSE
-    #endif
-    #ifndef OUTPUT_CELL_REMOVE
-        #define OUTPUT_CELL_REMOVE FALSE
-    #endif
-    #ifndef OUTPUT_NEW_CHUNK
-        #define OUTPUT_NEW_CHUNK   FALSE
-    #endif
-    #ifndef OUTPUT_FREE_CHUNKS
-        #define OUTPUT_FREE_CHUNKS FALSE
-    #endif
+// Trace Points (only recorded if the Code using this defines TRACE)
+#ifndef TRACE
+    #define TRACE(category, ...) ((void) 0)
 #endif
 
 // -------------------------------------------------------------------------- //
@@ -88,6 +76,10 @@ _Static_assert(
 //       0 % CHUNK_POINTER_IDX => becomes => 0 % CHUNK_SIZE - 1 = 0 - 1 = -1
 #define CHUNK_POINTER_IDX (CHUNK_SIZE - 1)
 
+#ifndef COUNT_NEW_CHUNK
+    #define COUNT_NEW_CHUNK() ((void) 0)
+#endif
+
 // Create an Alias for the Data Element Type
 typedef INNER_STRUCT Inner;
 
@@ -111,10 +103,16 @@ struct MemoryIterator {
     long curr_chunk;
 };
 
+// Contiguous Elements inside a single Chunk, so they can be processed in a
+// plain Loop instead of one Iter.next per Element.
+struct MemorySpan {
+    Inner * elems;
+    long len;
+};
+
 // -------------------------------------------------------------------------- //
 
 static struct MemoryIterator to_iter(struct MemoryManager * m) {
-    if (m == NULL) return NULL;
     struct MemoryIterator i = {
         .chunks = m->chunks,
         .num_elem = &m->num_elem,
@@ -142,9 +140,7 @@ static Inner * next (struct MemoryIterator * i) {
             // Redirect to the next Chunk
             i->chunks = (Inner *) i->chunks[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD;
             i->curr_chunk++;
-            #if OUTPUT_REDIRECTION == TRUE
-                printf("Redirecting Chunk to %p\n", i->chunks);
-            #endif
+            TRACE(REDIRECTION, "Redirecting Chunk to %#lx", i->chunks);
             return next(i);
         }
         return &i->chunks[(i->curr_idx++ + i->curr_chunk) % CHUNK_SIZE];
@@ -169,9 +165,7 @@ static Inner * peek (struct MemoryIterator * i) {
             }
             // Redirect to the next Chunk
             Inner * chunk = (Inner *) i->chunks[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD;
-            #if OUTPUT_REDIRECTION == TRUE
-                printf("Peeking Chunk %p\n", i->chunks);
-            #endif
+            TRACE(REDIRECTION, "Peeking Chunk %#lx", i->chunks);
             return &chunk[0];
         }
         return &i->chunks[(i->curr_idx + i->curr_chunk) % CHUNK_SIZE];
@@ -237,7 +231,6 @@ static Inner * previous (struct MemoryIterator * i) {
 // -------------------------------------------------------------------------- //
 
 static struct MemoryIterator clone_iter (struct MemoryIterator * i) {
-    if (i == NULL) return NULL;
     struct MemoryIterator clone = {
         .chunks = i->chunks,
         .num_elem = i->num_elem,
@@ -249,9 +242,41 @@ static struct MemoryIterator clone_iter (struct MemoryIterator * i) {
 
 // -------------------------------------------------------------------------- //
 
+// Return the remaining Elements of the current Chunk as one Span and move the
+// Iterator past them.
+// Returns an empty Span (len = 0) if all Elements where already returned.
+// Resolves Chunk Pointers.
+static struct MemorySpan next_span (struct MemoryIterator * i) {
+    struct MemorySpan span = {.elems = NULL, .len = 0};
+    if (i == NULL) return span;
+    // Check that the Iterator is still in the allocated Memory.
+    if (i->curr_idx >= *i->num_elem) return span;
+    long offset = (i->curr_idx + i->curr_chunk) % CHUNK_SIZE;
+    // Check if the current Element is the Chunk Pointer
+    if (offset == CHUNK_POINTER_IDX) {
+        // Check that more chunks are allocated.
+        if (((Inner *) i->chunks[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD) == NULL) {
+            return span;
+        }
+        // Redirect to the next Chunk
+        i->chunks = (Inner *) i->chunks[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD;
+        i->curr_chunk++;
+        TRACE(REDIRECTION, "Redirecting Chunk to %#lx", i->chunks);
+        offset = 0;
+    }
+    // The Span ends at the Chunk Pointer or at the last Element
+    span.elems = &i->chunks[offset];
+    span.len = CHUNK_POINTER_IDX - offset;
+    if (span.len > (*i->num_elem - i->curr_idx)) span.len = *i->num_elem - i->curr_idx;
+    i->curr_idx += span.len;
+    return span;
+}
+
+// -------------------------------------------------------------------------- //
+
 // Call a Closure on each Iterator Element.
 static void for_each (struct MemoryIterator * i, void (*func)(Inner *)) {
-    if (i == NULL) return NULL;
+    if (i == NULL) return;
     Inner * inner = next(i);
     while (inner != NULL) {
         func(inner);
@@ -261,6 +286,18 @@ static void for_each (struct MemoryIterator * i, void (*func)(Inner *)) {
 
 // -------------------------------------------------------------------------- //
 
+// Call a Closure on each Chunk Slice (instead of each Element).
+static void for_each_span (struct MemoryIterator * i, void (*func)(Inner *, long)) {
+    if (i == NULL) return;
+    struct MemorySpan span = next_span(i);
+    while (span.len > 0) {
+        func(span.elems, span.len);
+        span = next_span(i);
+    }
+}
+
+// -------------------------------------------------------------------------- //
+
 //
 struct {
     struct MemoryIterator (*iter)(struct MemoryManager *);
@@ -270,6 +307,8 @@ struct {
     struct MemoryIterator (*clone_iter) (struct MemoryIterator * i);
     Inner * (*previous) (struct MemoryIterator * i);
     void (*for_each) (struct MemoryIterator * i, void (*func)(Inner *));
+    struct MemorySpan (*next_span) (struct MemoryIterator * i);
+    void (*for_each_span) (struct MemoryIterator * i, void (*func)(Inner *, long));
 } Iter = {
     .iter = to_iter,
     .next = next,
@@ -277,7 +316,9 @@ struct {
     .next_back = next_back,
     .clone_iter = clone_iter,
     .previous = previous,
-    .for_each = for_each
+    .for_each = for_each,
+    .next_span = next_span,
+    .for_each_span = for_each_span
 };
 
 // -------------------------------------------------------------------------- //
@@ -295,7 +336,12 @@ void deallocate_chunks (struct MemoryManager * m);
 void reset(struct MemoryManager * m);
 static void deallocate_chunks_inner (Inner * c);
 int add_elem (struct MemoryManager * m, Inner c);
+int add_elems (struct MemoryManager * m, const Inner * elems, long count);
+int append_elems (struct MemoryManager * m, struct MemoryManager * other);
 int remove_elem (struct MemoryManager * m, long idx);
+long remove_elems_if (struct MemoryManager * m, bool (*pred)(Inner *));
+static Inner * link_chunk (struct MemoryManager * m, Inner * last_chunk);
+static void truncate_chunks (struct MemoryManager * m, Inner * last_chunk, long used_chunks);
 Inner * get_elem (struct MemoryManager m, long idx);
 static Inner * get_elem_inner (Inner * c, long idx);
 Inner * get_chunk_pointer (struct MemoryManager m, long idx);
@@ -320,12 +366,11 @@ int init_chunks (struct MemoryManager * m) {
     m->chunks = chunk;
     m->chunks[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD = 0;
     m->allocated_chunks ++;
+    COUNT_NEW_CHUNK();
     // Reset Element Count
     m->num_elem = 0;
 
-    #if OUTPUT_NEW_CHUNK
-        printf("Initial Chunk: %p\n", chunk);
-    #endif
+    TRACE(NEW_CHUNK, "Initial Chunk: %#lx", chunk);
 
     return 0;
 }
@@ -345,14 +390,13 @@ int allocate_chunk(struct MemoryManager * m) {
     }
     // Create Pointer to the new Chunk at the End of the last Chunk.
     last_chunk_pointer->x = (long) new_chunk;
-    #if OUTPUT_NEW_CHUNK == TRUE
-        printf("New Chunk: %p\n", (Inner *) last_chunk_pointer->x);
-    #endif
+    TRACE(NEW_CHUNK, "New Chunk: %#lx", (Inner *) last_chunk_pointer->x);
     // Create null pointer instead of pointer to the next Chunk.
     // This is basically a sign that no more chunks are allocated after this.
     new_chunk[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD = 0;
     // Increment number of allocated Chunks
     m->allocated_chunks += 1;
+    COUNT_NEW_CHUNK();
     return 0;
 }
 
@@ -368,9 +412,7 @@ static int deallocate_last_chunk (struct MemoryManager * m) {
     // Check that the Pointer is not NULL.
     if (p1 == NULL) return -1;
 
-    #if OUTPUT_FREE_CHUNKS == TRUE
-        printf("Freeing: %p\n", (Inner *) p1->x);
-    #endif
+    TRACE(FREE_CHUNKS, "Freeing: %#lx", (Inner *) p1->x);
 
     // Deallocate the Chunk AFTER checking for Null Pointers.
     free((Inner *) p1->x);
@@ -396,9 +438,7 @@ static void deallocate_chunks_inner (Inner * c) {
     // Check if the passed Pointer is the last Chunk Pointer
     // If a chunk is allocated after this skip the If-Block.
     if ((Inner *) c[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD == NULL) {
-        #if OUTPUT_FREE_CHUNKS == TRUE
-            printf("Freeing: %p\n", c);
-        #endif
+        TRACE(FREE_CHUNKS, "Freeing: %#lx", c);
         // Then free it and return.
         // At this Point the Chunk Pointers will recursively be freed.
         free(c);
@@ -407,9 +447,7 @@ static void deallocate_chunks_inner (Inner * c) {
     }
     // Call this recursively passing in the next Chunk.
     deallocate_chunks_inner((Inner *) c[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD);
-    #if OUTPUT_FREE_CHUNKS == TRUE
-        printf("Freeing: %p\n", c);
-    #endif
+    TRACE(FREE_CHUNKS, "Freeing: %#lx", c);
     // Free the current Chunk.
     // At this point this is the last allocated Chunk because all
     // Chunks before it were recursively freed.
@@ -427,15 +465,46 @@ void reset(struct MemoryManager * m) {
     m->num_elem = 0;
 
     #if DEALLOCATE_UNUSED_CHUNKS == TRUE
-        if ((Inner *) m->chunks[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD != NULL) {
-            // Deallocate all Chunks except the first one.
-            deallocate_chunks_inner((Inner *) m->chunks[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD);
-        }
+        // Deallocate all Chunks except the first one.
+        truncate_chunks(m, m->chunks, 1);
     #endif
 }
 
 // -------------------------------------------------------------------------- //
 
+// Private Helper Function which frees all Chunks after last_chunk.
+// The Chunk Pointer of last_chunk is cleared, so it becomes the new end
+// of the Linked List, and used_chunks is the number of Chunks up to and
+// including last_chunk.
+static void truncate_chunks (struct MemoryManager * m, Inner * last_chunk, long used_chunks) {
+    Inner * next_chunk = (Inner *) last_chunk[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD;
+    if (next_chunk != NULL) {
+        deallocate_chunks_inner(next_chunk);
+        last_chunk[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD = 0;
+    }
+    m->allocated_chunks = used_chunks;
+}
+
+// -------------------------------------------------------------------------- //
+
+// Private Helper Function which allocates a new Chunk and links it behind
+// last_chunk.
+// Unlike allocate_chunk this does not have to walk the Linked List to find
+// the last Chunk, because the Caller already holds it.
+// Returns the new Chunk or NULL if no Memory could be allocated.
+static Inner * link_chunk (struct MemoryManager * m, Inner * last_chunk) {
+    Inner * new_chunk = malloc(CHUNK_SIZE * sizeof(Inner));
+    if (new_chunk == NULL) return NULL;
+    new_chunk[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD = 0;
+    last_chunk[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD = (long) new_chunk;
+    TRACE(NEW_CHUNK, "New Chunk: %#lx", new_chunk);
+    m->allocated_chunks += 1;
+    COUNT_NEW_CHUNK();
+    return new_chunk;
+}
+
+// -------------------------------------------------------------------------- //
+
 // Add Cell, allocating more Space if needed
 // Returns  0 if Operation succeded.
 // Returns -1 if no Space could be allocated anymore
@@ -453,9 +522,7 @@ int add_elem (struct MemoryManager * m, Inner c) {
         if (allocate_chunk(m) >= 0)
             return add_elem(m, c);
     } else {
-        #if OUTPUT_CELL_ASSIGN == TRUE
-            printf("\tAdding Cell: %p\n", p);
-        #endif
+        TRACE(CELL_ASSIGN, "Adding Cell: %#lx", p);
         // If there still is space append the Data Element into the Chunk.
         *p = c;
         m->num_elem ++;
@@ -467,6 +534,128 @@ int add_elem (struct MemoryManager * m, Inner c) {
 
 // -------------------------------------------------------------------------- //
 
+// Append count Elements from the elems-Array, allocating more Space if needed.
+// Instead of resolving the Linked List for every Element (like add_elem does)
+// the last Chunk is only looked up once and the Elements are copied into it
+// with one memcpy per Chunk.
+// Returns  0 if Operation succeded.
+// Returns -1 if no Space could be allocated anymore
+// NOTE: If allocating fails midway, the Elements which were already copied
+//       stay in the MemoryManager (num_elem is always kept accurate).
+int add_elems (struct MemoryManager * m, const Inner * elems, long count) {
+    if ((m == NULL) || (elems == NULL) || (count < 0)) return -1;
+
+    Inner * chunk = m->chunks;
+    // Index of the next free Slot relative to the current Chunk
+    long idx = m->num_elem;
+    long space;
+
+    while (count > 0) {
+        // Skip Chunks which are already full
+        if (idx >= CHUNK_POINTER_IDX) {
+            Inner * next_chunk = (Inner *) chunk[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD;
+            if (next_chunk == NULL) {
+                next_chunk = link_chunk(m, chunk);
+                if (next_chunk == NULL) return -1;
+            }
+            chunk = next_chunk;
+            idx -= CHUNK_POINTER_IDX;
+            continue;
+        }
+        // Fill the rest of the current Chunk in one go
+        space = CHUNK_POINTER_IDX - idx;
+        if (space > count) space = count;
+        memcpy(&chunk[idx], elems, space * sizeof(Inner));
+        TRACE(CELL_ASSIGN, "Adding %ld Cells: %#lx", space, &chunk[idx]);
+        elems += space;
+        count -= space;
+        idx += space;
+        m->num_elem += space;
+    }
+
+    return 0;
+}
+
+// -------------------------------------------------------------------------- //
+
+// Append all Elements of the MemoryManager other to m, copying them Chunk by
+// Chunk with add_elems.
+// Returns  0 if Operation succeded.
+// Returns -1 if no Space could be allocated anymore
+int append_elems (struct MemoryManager * m, struct MemoryManager * other) {
+    if ((m == NULL) || (other == NULL)) return -1;
+
+    Inner * chunk = other->chunks;
+    long remaining = other->num_elem;
+    long count;
+
+    while (remaining > 0) {
+        count = (remaining < CHUNK_POINTER_IDX) ? remaining : CHUNK_POINTER_IDX;
+        if (add_elems(m, chunk, count) < 0) return -1;
+        remaining -= count;
+        chunk = (Inner *) chunk[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD;
+    }
+
+    return 0;
+}
+
+// -------------------------------------------------------------------------- //
+
+// Remove all Elements for which pred returns true in a single Pass.
+// The remaining Elements are moved to the Front (keeping their Order) and
+// Chunks which no longer contain any Elements are deallocated afterwards.
+// pred is called exactly once per Element in Order, so it may also update
+// the Element it is passed.
+// Returns the number of removed Elements or -1 if an Error occured.
+long remove_elems_if (struct MemoryManager * m, bool (*pred)(Inner *)) {
+    if ((m == NULL) || (pred == NULL)) return -1;
+
+    // Read Position
+    Inner * read_chunk = m->chunks;
+    long read_idx = 0;
+    // Write Position
+    Inner * write_chunk = m->chunks;
+    long write_idx = 0;
+    long write_chunks = 1;
+
+    long kept = 0;
+
+    for (long iLauf = 0; iLauf < m->num_elem; iLauf ++) {
+        if (read_idx == CHUNK_POINTER_IDX) {
+            read_chunk = (Inner *) read_chunk[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD;
+            read_idx = 0;
+        }
+        if (!pred(&read_chunk[read_idx])) {
+            // The Write Position can never overtake the Read Position, so the
+            // next Chunk is guaranteed to exist.
+            if (write_idx == CHUNK_POINTER_IDX) {
+                write_chunk = (Inner *) write_chunk[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD;
+                write_idx = 0;
+                write_chunks ++;
+            }
+            if (&write_chunk[write_idx] != &read_chunk[read_idx]) {
+                write_chunk[write_idx] = read_chunk[read_idx];
+            }
+            write_idx ++;
+            kept ++;
+        } else {
+            TRACE(CELL_REMOVE, "Removing Cell %ld = %#lx", iLauf, &read_chunk[read_idx]);
+        }
+        read_idx ++;
+    }
+
+    long removed = m->num_elem - kept;
+    m->num_elem = kept;
+
+    #if DEALLOCATE_UNUSED_CHUNKS == TRUE
+        truncate_chunks(m, write_chunk, write_chunks);
+    #endif
+
+    return removed;
+}
+
+// -------------------------------------------------------------------------- //
+
 // Overwrite the Cell at the specified Index
 // with the Cell at the last Position, removing it.
 // This is possible because the order of the cells
@@ -480,12 +669,7 @@ int remove_elem (struct MemoryManager * m, long idx) {
     // just decrease the Cell-Count (the next add_cell-Call
     // will overwrite it).
     else if (idx == (m->num_elem - 1)) {
-    #if OUTPUT_CELL_REMOVE == TRUE
-        printf(
-            "Removing last Cell %ld = %p\n",
-            idx, get_elem(*m, m->num_elem - 1)
-        );
-    #endif
+        TRACE(CELL_REMOVE, "Removing last Cell %ld = %#lx", idx, get_elem(*m, m->num_elem - 1));
         m->num_elem--;
         // If no more Cells remain in the last Chunk deallocate it.
         if ((m->num_elem % CHUNK_POINTER_IDX) == (CHUNK_POINTER_IDX - 1)) {
@@ -500,12 +684,7 @@ int remove_elem (struct MemoryManager * m, long idx) {
     if ((p1 == NULL) || (p2 == NULL)) {
         return -1;
     }
-    #if OUTPUT_CELL_REMOVE == TRUE
-        printf(
-            "Removing Cell %ld = %p (replacing with: %ld = %p)\n",
-            idx, p2, m->num_elem-1, p1
-        );
-    #endif
+    TRACE(CELL_REMOVE, "Removing Cell %ld = %#lx (replacing with: %ld = %#lx)", idx, p2, m->num_elem-1, p1);
     // Overwrite the Cell at the specified Index with the
     // Cell at the End of the Array.
     // Because the order of the cells doesn't matter this can be done.
@@ -541,9 +720,7 @@ static Inner * get_elem_inner (Inner * c, long idx) {
         return &(c[idx]);
     // If not check if there is another allocated Chunk
     if (c[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD != 0) {
-        #if OUTPUT_REDIRECTION == TRUE
-            printf("Chunk Redirection to: %p\n", (Inner *) c[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD);
-        #endif
+        TRACE(REDIRECTION, "Chunk Redirection to: %#lx", (Inner *) c[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD);
         // Recursively resolve Chunk Pointers
         return get_elem_inner((Inner *) c[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD, idx-CHUNK_SIZE+1);
     }
@@ -564,9 +741,7 @@ Inner * get_chunk_pointer (struct MemoryManager m, long idx) {
 // Private Helper Function for get_chunk_pointer
 static Inner * get_chunk_pointer_inner (Inner * c, long idx) {
     if ((idx == 0) || ((Inner *) c[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD == NULL)) {
-        #if OUTPUT_REDIRECTION == TRUE
-            printf("Chunk Redirection to: %p\n", (Inner *) c[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD);
-        #endif
+        TRACE(REDIRECTION, "Chunk Redirection to: %#lx", (Inner *) c[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD);
         return &c[CHUNK_POINTER_IDX];
     }
     return get_chunk_pointer_inner((Inner *) c[CHUNK_POINTER_IDX].CHUNK_POINTER_FIELD, idx-1);
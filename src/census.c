@@ -0,0 +1,599 @@
+
+// -------------------------------------------------------------------------- //
+// --- Explanation ---------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Census of the Objects left over once the Soups of a Batch settled (the
+// Ash), written as CSV sorted by their Count:
+//
+//      ./game 16 16 0.5 1000 --batch soups.txt --census census.csv
+//
+//      object,kind,count
+//      xs4_33,still life,5170
+//      xp2_7,oscillator,3304
+//      xq4_153,spaceship,412
+//
+// 1. The last Generation of a Board is split into its Objects, i.e. the
+//    Groups of alive Cells which touch each other (including diagonally).
+// 2. Every Object is played on its own for up to CENSUS_PERIOD Generations.
+//    If it comes back to its first Generation it is a Still Life (Period 1)
+//    or an Oscillator, if it comes back somewhere else it is a Spaceship.
+//    Otherwise (e.g. Objects which only are stable together with a Neighbour)
+//    it is unknown.
+// 3. The Object gets a Name in the Style of the apgcodes used by Catagolue:
+//
+//      xs<Population>_<Code>   => Still Life
+//      xp<Period>_<Code>       => Oscillator
+//      xq<Period>_<Code>       => Spaceship
+//      zz_<Code>               => Unknown
+//
+//    The Code stores the Pattern in Strips of 5 Rows. Every Column of a
+//    Strip is a Character (0-9 and a-v for the 5 Bits, the top Row is Bit 0)
+//    and the Strips are separated by a 'z'. Runs of empty Columns are
+//    shortened to 'w' (2), 'x' (3) or 'y' followed by their Count - 4
+//    and empty Columns at the End of a Strip are left out.
+//    Since the same Object can be found in every Phase and in every one of
+//    its 8 Orientations (rotated and mirrored), the shortest (and then
+//    alphabetically first) Code of all of them is its Name.
+//
+// The Objects are found by the Threads of the Batch, so every Thread counts
+// them in its own Hash Table, which maps the Code of the Object as it was
+// found (in that Phase and Orientation) to its Name. The same Objects show
+// up over and over again, so they are only played and named once per
+// Thread. The Tables of the Threads are merged once all Boards are done.
+//
+// NOTE: On a Torus Objects crossing an Edge are split into two.
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Maximum Period of the Oscillators and Spaceships which are recognized
+#ifndef CENSUS_PERIOD
+    #define CENSUS_PERIOD 30
+#endif
+
+// What an Object turned out to be when it was played on its own
+#define CENSUS_KINDS(KIND) \
+    KIND(STILL_LIFE,  "still life") \
+    KIND(OSCILLATOR,  "oscillator") \
+    KIND(SPACESHIP,   "spaceship") \
+    KIND(UNKNOWN,     "unknown")
+
+#define CENSUS_KIND_ENUM(name, text) CENSUS_##name,
+enum CensusKind {
+    CENSUS_KINDS(CENSUS_KIND_ENUM)
+};
+#undef CENSUS_KIND_ENUM
+
+struct CensusObject {
+    // Key of the Table
+    char * key;
+    // Name of the Object (the Key if the Table is keyed by Name)
+    char * name;
+    enum CensusKind kind;
+    long count;
+};
+
+// Hash Table of Objects using Open Addressing (key == NULL => Slot is free)
+struct CensusTable {
+    struct CensusObject * objects;
+    long size;
+    long capacity;
+};
+
+struct CensusCell {
+    int x;
+    int y;
+};
+
+// Table and Buffers of a Thread
+struct Census {
+    struct CensusTable table;
+    // Copy of the Board, whose Cells are removed once they belong to an Object
+    struct Bitmap work;
+    // The Object played on its own
+    struct Bitmap play[2];
+    // Cells of the current Object
+    struct CensusCell * cells;
+    long cells_capacity;
+    // Pattern of the current Object (one Byte per Cell)
+    char * grid;
+    size_t grid_capacity;
+    // Code of the Pattern and the shortest one found so far
+    char * code;
+    char * best;
+    size_t code_capacity;
+};
+
+// -------------------------------------------------------------------------- //
+
+int census_board (struct Census * c, const struct Bitmap * board, const struct Kernel * kernel);
+void uninit_census (struct Census * c);
+int merge_census (struct CensusTable * total, const struct Census * c);
+int write_census (const char * path, const struct CensusTable * total);
+void uninit_census_table (struct CensusTable * t, bool keyed_by_name);
+static int census_object (struct Census * c, long count, const struct Kernel * kernel);
+static int name_object (struct Census * c, long count, int width, int height, const struct Kernel * kernel, char ** name, enum CensusKind * kind);
+static int grid_pattern (struct Census * c, const struct Bitmap * b, int * width, int * height, long * population, int * x, int * y);
+static int grow_census_buffers (struct Census * c, int width, int height);
+static void best_code (struct Census * c, int width, int height);
+static size_t encode_pattern (const char * grid, int width, int height, int transform, char * code);
+static struct CensusObject * find_census_object (struct CensusTable * t, const char * key, bool create);
+static int compare_census_objects (const void * a, const void * b);
+static uint64_t census_hash (const char * key);
+
+// -------------------------------------------------------------------------- //
+
+// Find, name and count all Objects of the Board.
+// Returns -1 if no Memory could be allocated.
+int census_board (struct Census * c, const struct Bitmap * board, const struct Kernel * kernel) {
+
+    if (reshape_bitmap(&c->work, board->width, board->height) < 0) return -1;
+    for (long iLauf = 0; iLauf < board->height; iLauf ++) {
+        memcpy(bitmap_row(&c->work, iLauf), bitmap_row(board, iLauf), sizeof(u64) * board->words);
+        bitmap_row(&c->work, iLauf)[board->words - 1] &= board->tail_mask;
+    }
+
+    const long max_cells = (long) board->width * board->height;
+    if (max_cells > c->cells_capacity) {
+        struct CensusCell * cells = realloc(c->cells, sizeof(struct CensusCell) * max_cells);
+        if (cells == NULL) return -1;
+        c->cells = cells;
+        c->cells_capacity = max_cells;
+    }
+
+    for (long iLauf = 0; iLauf < board->height; iLauf ++) {
+        u64 * row = bitmap_row(&c->work, iLauf);
+        for (long iLauf2 = 0; iLauf2 < board->words; iLauf2 ++) {
+            while (row[iLauf2] != 0) {
+                // Collect the Object of the first Cell left using the Cells as
+                // a Queue
+                const int x = iLauf2 * 64 + __builtin_ctzll(row[iLauf2]);
+                set_bit(&c->work, x, iLauf, false);
+                c->cells[0].x = x;
+                c->cells[0].y = iLauf;
+                long count = 1;
+                for (long iLauf3 = 0; iLauf3 < count; iLauf3 ++) {
+                    const struct CensusCell cell = c->cells[iLauf3];
+                    for (int dy = -1; dy <= 1; dy ++) {
+                        for (int dx = -1; dx <= 1; dx ++) {
+                            const int nx = cell.x + dx;
+                            const int ny = cell.y + dy;
+                            if (
+                                (nx < 0) || (ny < 0) || (nx >= board->width) ||
+                                (ny >= board->height) || !get_bit(&c->work, nx, ny)
+                            ) {
+                                continue;
+                            }
+                            set_bit(&c->work, nx, ny, false);
+                            c->cells[count].x = nx;
+                            c->cells[count].y = ny;
+                            count ++;
+                        }
+                    }
+                }
+                if (census_object(c, count, kernel) < 0) return -1;
+            }
+        }
+    }
+
+    return 0;
+
+}
+
+void uninit_census (struct Census * c) {
+    uninit_census_table(&c->table, false);
+    uninit_bitmap(&c->work);
+    uninit_bitmap(&c->play[0]);
+    uninit_bitmap(&c->play[1]);
+    free(c->cells);
+    free(c->grid);
+    free(c->code);
+    free(c->best);
+}
+
+// -------------------------------------------------------------------------- //
+
+// Add the Counts of the Thread to total, which is keyed by the Names.
+// Returns -1 if no Memory could be allocated.
+int merge_census (struct CensusTable * total, const struct Census * c) {
+    for (long iLauf = 0; iLauf < c->table.capacity; iLauf ++) {
+        const struct CensusObject * o = &c->table.objects[iLauf];
+        if (o->key == NULL) continue;
+        struct CensusObject * sum = find_census_object(total, o->name, true);
+        if (sum == NULL) return -1;
+        sum->name = sum->key;
+        sum->kind = o->kind;
+        sum->count += o->count;
+    }
+    return 0;
+}
+
+// Write the Objects sorted by their Count (see Explanation).
+// Returns -1 if the File could not be written.
+int write_census (const char * path, const struct CensusTable * total) {
+
+    const struct CensusObject ** sorted = malloc(sizeof(struct CensusObject *) * (total->size + 1));
+    if (sorted == NULL) return -1;
+    long count = 0;
+    for (long iLauf = 0; iLauf < total->capacity; iLauf ++) {
+        if (total->objects[iLauf].key != NULL) sorted[count ++] = &total->objects[iLauf];
+    }
+    qsort(sorted, count, sizeof(struct CensusObject *), compare_census_objects);
+
+    #define CENSUS_KIND_TEXT(name, text) text,
+    static const char * kinds[] = {
+        CENSUS_KINDS(CENSUS_KIND_TEXT)
+    };
+    #undef CENSUS_KIND_TEXT
+
+    FILE * file = fopen(path, "w");
+    if (file == NULL) {
+        free(sorted);
+        return -1;
+    }
+    fprintf(file, "object,kind,count\n");
+    for (long iLauf = 0; iLauf < count; iLauf ++) {
+        fprintf(file, "%s,%s,%ld\n", sorted[iLauf]->name, kinds[sorted[iLauf]->kind], sorted[iLauf]->count);
+    }
+    free(sorted);
+
+    int result = ferror(file) ? -1 : 0;
+    if (fclose(file) != 0) result = -1;
+    return result;
+
+}
+
+// Free the Table (keyed_by_name => The Names are the Keys)
+void uninit_census_table (struct CensusTable * t, bool keyed_by_name) {
+    for (long iLauf = 0; iLauf < t->capacity; iLauf ++) {
+        free(t->objects[iLauf].key);
+        if (!keyed_by_name) free(t->objects[iLauf].name);
+    }
+    free(t->objects);
+    t->objects = NULL;
+    t->size = 0;
+    t->capacity = 0;
+}
+
+// -------------------------------------------------------------------------- //
+
+// Count the Object made of the first count Cells, naming it if it was not
+// found by the Thread before.
+// Returns -1 if no Memory could be allocated.
+static int census_object (struct Census * c, long count, const struct Kernel * kernel) {
+
+    int x0 = c->cells[0].x, x1 = x0;
+    int y0 = c->cells[0].y, y1 = y0;
+    for (long iLauf = 1; iLauf < count; iLauf ++) {
+        if (c->cells[iLauf].x < x0) x0 = c->cells[iLauf].x;
+        if (c->cells[iLauf].x > x1) x1 = c->cells[iLauf].x;
+        if (c->cells[iLauf].y < y0) y0 = c->cells[iLauf].y;
+        if (c->cells[iLauf].y > y1) y1 = c->cells[iLauf].y;
+    }
+    const int width = x1 - x0 + 1;
+    const int height = y1 - y0 + 1;
+
+    // Move the Object to (0, 0) and draw it into the Grid
+    if (grow_census_buffers(c, width, height) < 0) return -1;
+    memset(c->grid, 0, (size_t) width * height);
+    for (long iLauf = 0; iLauf < count; iLauf ++) {
+        c->cells[iLauf].x -= x0;
+        c->cells[iLauf].y -= y0;
+        c->grid[c->cells[iLauf].y * width + c->cells[iLauf].x] = 1;
+    }
+
+    encode_pattern(c->grid, width, height, 0, c->code);
+    struct CensusObject * o = find_census_object(&c->table, c->code, true);
+    if (o == NULL) return -1;
+    if (o->name == NULL) {
+        // Keep the Cells (the Grid and the Codes are reused for the Phases)
+        if (name_object(c, count, width, height, kernel, &o->name, &o->kind) < 0) return -1;
+    }
+    o->count ++;
+
+    return 0;
+
+}
+
+// Play the Object made of the first count Cells (moved to (0, 0)) on its own
+// to find out what it is and give it its Name (see Explanation).
+// Returns -1 if no Memory could be allocated.
+static int name_object (
+    struct Census * c, long count, int width, int height, const struct Kernel * kernel,
+    char ** name, enum CensusKind * kind
+) {
+
+    // Leave enough Room around the Object for a Spaceship (or anything
+    // growing at the Speed of Light)
+    const int margin = CENSUS_PERIOD + 1;
+    struct Bitmap * curr = &c->play[0];
+    struct Bitmap * next = &c->play[1];
+    struct Bitmap * temp;
+    if (
+        (reshape_bitmap(curr, width + 2 * margin, height + 2 * margin) < 0) ||
+        (reshape_bitmap(next, width + 2 * margin, height + 2 * margin) < 0)
+    ) {
+        return -1;
+    }
+    for (long iLauf = 0; iLauf < count; iLauf ++) {
+        set_bit(curr, c->cells[iLauf].x + margin, c->cells[iLauf].y + margin, true);
+    }
+
+    // Shortest Code of the first Phase and of all Phases
+    best_code(c, width, height);
+    char * found = strdup(c->best);
+    char * first = strdup(c->best);
+    if ((found == NULL) || (first == NULL)) {
+        free(found);
+        free(first);
+        return -1;
+    }
+
+    *kind = CENSUS_UNKNOWN;
+    int period = 0;
+    for (int iLauf = 1; iLauf <= CENSUS_PERIOD; iLauf ++) {
+        run_kernel(kernel, curr, next, 0, curr->height, 0, curr->words, NULL);
+        temp = curr;
+        curr = next;
+        next = temp;
+
+        int w, h, x, y;
+        long population;
+        if (grid_pattern(c, curr, &w, &h, &population, &x, &y) < 0) {
+            free(found);
+            free(first);
+            return -1;
+        }
+        if (population == 0) break;
+
+        // Back to the first Phase?
+        if ((population == count) && (w == width) && (h == height)) {
+            bool same = true;
+            for (long iLauf2 = 0; same && (iLauf2 < count); iLauf2 ++) {
+                same = c->grid[c->cells[iLauf2].y * w + c->cells[iLauf2].x];
+            }
+            if (same) {
+                period = iLauf;
+                if ((x != margin) || (y != margin)) {
+                    *kind = CENSUS_SPACESHIP;
+                } else {
+                    *kind = (period == 1) ? CENSUS_STILL_LIFE : CENSUS_OSCILLATOR;
+                }
+                break;
+            }
+        }
+
+        // Keep the shortest Code of all Phases
+        best_code(c, w, h);
+        if (
+            (strlen(c->best) < strlen(first)) ||
+            ((strlen(c->best) == strlen(first)) && (strcmp(c->best, first) < 0))
+        ) {
+            free(first);
+            first = strdup(c->best);
+            if (first == NULL) {
+                free(found);
+                return -1;
+            }
+        }
+    }
+
+    char prefix[32];
+    switch (*kind) {
+        case CENSUS_STILL_LIFE: snprintf(prefix, sizeof(prefix), "xs%ld_", count); break;
+        case CENSUS_OSCILLATOR: snprintf(prefix, sizeof(prefix), "xp%d_", period); break;
+        case CENSUS_SPACESHIP: snprintf(prefix, sizeof(prefix), "xq%d_", period); break;
+        default: snprintf(prefix, sizeof(prefix), "zz_"); break;
+    }
+    // Without a Period only the Phase the Object was found in belongs to it
+    const char * code = (*kind == CENSUS_UNKNOWN) ? found : first;
+
+    *name = malloc(strlen(prefix) + strlen(code) + 1);
+    if (*name != NULL) {
+        strcpy(*name, prefix);
+        strcat(*name, code);
+    }
+    free(found);
+    free(first);
+
+    return (*name == NULL) ? -1 : 0;
+
+}
+
+// Draw the alive Cells of the Bitmap into the Grid (moved to (0, 0)) and get
+// the Size, Population and Position of their Bounding Box.
+// Returns -1 if no Memory could be allocated.
+static int grid_pattern (
+    struct Census * c, const struct Bitmap * b,
+    int * width, int * height, long * population, int * x, int * y
+) {
+
+    int x0 = b->width, x1 = -1, y0 = b->height, y1 = -1;
+    *population = 0;
+    for (long iLauf = 0; iLauf < b->height; iLauf ++) {
+        const u64 * row = bitmap_row(b, iLauf);
+        for (long iLauf2 = 0; iLauf2 < b->words; iLauf2 ++) {
+            if (row[iLauf2] == 0) continue;
+            const int first = iLauf2 * 64 + __builtin_ctzll(row[iLauf2]);
+            const int last = iLauf2 * 64 + 63 - __builtin_clzll(row[iLauf2]);
+            if (first < x0) x0 = first;
+            if (last > x1) x1 = last;
+            if (iLauf < y0) y0 = iLauf;
+            y1 = iLauf;
+            *population += __builtin_popcountll(row[iLauf2]);
+        }
+    }
+    if (*population == 0) return 0;
+
+    *width = x1 - x0 + 1;
+    *height = y1 - y0 + 1;
+    *x = x0;
+    *y = y0;
+
+    if (grow_census_buffers(c, *width, *height) < 0) return -1;
+    for (long iLauf = 0; iLauf < *height; iLauf ++) {
+        for (long iLauf2 = 0; iLauf2 < *width; iLauf2 ++) {
+            c->grid[iLauf * *width + iLauf2] = get_bit(b, x0 + iLauf2, y0 + iLauf);
+        }
+    }
+
+    return 0;
+
+}
+
+// Make the Grid and the Codes big enough for a Pattern of the Size.
+// Returns -1 if no Memory could be allocated.
+static int grow_census_buffers (struct Census * c, int width, int height) {
+    const size_t size = (size_t) width * height;
+    const size_t code_size = (size_t) (height / 5 + 1) * (width + 1) + (width / 5 + 1) * (height + 1) + 32;
+    if (size > c->grid_capacity) {
+        char * grid = realloc(c->grid, size);
+        if (grid == NULL) return -1;
+        c->grid = grid;
+        c->grid_capacity = size;
+    }
+    if (code_size > c->code_capacity) {
+        char * code = realloc(c->code, code_size);
+        if (code == NULL) return -1;
+        c->code = code;
+        char * best = realloc(c->best, code_size);
+        if (best == NULL) return -1;
+        c->best = best;
+        c->code_capacity = code_size;
+    }
+    return 0;
+}
+
+// Find the shortest (and then alphabetically first) Code of the Pattern in
+// the Grid in all 8 Orientations and store it in best.
+static void best_code (struct Census * c, int width, int height) {
+    size_t best_length = encode_pattern(c->grid, width, height, 0, c->best);
+    for (int iLauf = 1; iLauf < 8; iLauf ++) {
+        const size_t length = encode_pattern(c->grid, width, height, iLauf, c->code);
+        if ((length < best_length) || ((length == best_length) && (strcmp(c->code, c->best) < 0))) {
+            memcpy(c->best, c->code, length + 1);
+            best_length = length;
+        }
+    }
+}
+
+// Write the Code of the Pattern (see Explanation) in one of its 8
+// Orientations:
+//      Bit 0 => Mirrored horizontally
+//      Bit 1 => Mirrored vertically
+//      Bit 2 => Rows and Columns swapped
+// Returns the Length of the Code.
+static size_t encode_pattern (const char * grid, int width, int height, int transform, char * code) {
+
+    const bool swap = transform & 4;
+    const int out_width = swap ? height : width;
+    const int out_height = swap ? width : height;
+    static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+    size_t length = 0;
+    for (int strip = 0; strip < out_height; strip += 5) {
+        if (strip > 0) code[length ++] = 'z';
+        int zeros = 0;
+        for (int iLauf = 0; iLauf < out_width; iLauf ++) {
+            int value = 0;
+            for (int iLauf2 = 0; (iLauf2 < 5) && ((strip + iLauf2) < out_height); iLauf2 ++) {
+                int u = swap ? (strip + iLauf2) : iLauf;
+                int v = swap ? iLauf : (strip + iLauf2);
+                if (transform & 1) u = width - 1 - u;
+                if (transform & 2) v = height - 1 - v;
+                value |= grid[v * width + u] << iLauf2;
+            }
+            if (value == 0) {
+                zeros ++;
+                continue;
+            }
+            // Write the empty Columns before this one
+            while (zeros > 0) {
+                if (zeros >= 4) {
+                    const int run = (zeros > 39) ? 39 : zeros;
+                    code[length ++] = 'y';
+                    code[length ++] = digits[run - 4];
+                    zeros -= run;
+                } else if (zeros == 3) {
+                    code[length ++] = 'x';
+                    zeros = 0;
+                } else if (zeros == 2) {
+                    code[length ++] = 'w';
+                    zeros = 0;
+                } else {
+                    code[length ++] = '0';
+                    zeros = 0;
+                }
+            }
+            code[length ++] = digits[value];
+        }
+    }
+    code[length] = '\0';
+
+    return length;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Find the Object with the Key, adding it (with a Copy of the Key) if create
+// is set.
+// Returns NULL if it was not found or no Memory could be allocated.
+static struct CensusObject * find_census_object (struct CensusTable * t, const char * key, bool create) {
+
+    // Keep the Table at most half full
+    if (create && ((2 * (t->size + 1)) > t->capacity)) {
+        const long capacity = t->capacity ? (2 * t->capacity) : 256;
+        struct CensusObject * objects = calloc(capacity, sizeof(struct CensusObject));
+        if (objects == NULL) return NULL;
+        for (long iLauf = 0; iLauf < t->capacity; iLauf ++) {
+            if (t->objects[iLauf].key == NULL) continue;
+            long idx = census_hash(t->objects[iLauf].key) & (capacity - 1);
+            while (objects[idx].key != NULL) idx = (idx + 1) & (capacity - 1);
+            objects[idx] = t->objects[iLauf];
+        }
+        free(t->objects);
+        t->objects = objects;
+        t->capacity = capacity;
+    }
+    if (t->capacity == 0) return NULL;
+
+    long idx = census_hash(key) & (t->capacity - 1);
+    while (t->objects[idx].key != NULL) {
+        if (strcmp(t->objects[idx].key, key) == 0) return &t->objects[idx];
+        idx = (idx + 1) & (t->capacity - 1);
+    }
+    if (!create) return NULL;
+
+    t->objects[idx].key = strdup(key);
+    if (t->objects[idx].key == NULL) return NULL;
+    t->objects[idx].name = NULL;
+    t->objects[idx].kind = CENSUS_UNKNOWN;
+    t->objects[idx].count = 0;
+    t->size ++;
+
+    return &t->objects[idx];
+
+}
+
+// Sort by Count (highest first) and then by Name
+static int compare_census_objects (const void * a, const void * b) {
+    const struct CensusObject * self = *(const struct CensusObject * const *) a;
+    const struct CensusObject * other = *(const struct CensusObject * const *) b;
+    if (self->count != other->count) return (self->count > other->count) ? -1 : 1;
+    return strcmp(self->name, other->name);
+}
+
+// FNV-1a
+static uint64_t census_hash (const char * key) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    while (*key != '\0') {
+        hash ^= (unsigned char) *key ++;
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+// -------------------------------------------------------------------------- //
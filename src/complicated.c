@@ -2,43 +2,48 @@
 // -------------------------------------------------------------------------- //
 
 #include "cell.c"
+#include "profile.c"
+#include "options.c"
 
 // -------------------------------------------------------------------------- //
 
 #define INNER_STRUCT struct Cell
 #define CHUNK_POINTER_FIELD x
+#define COUNT_NEW_CHUNK() PROFILE_COUNT(chunks, 1)
 
 #include "cell_alloc.c"
+#include "stats.c"
 
 // -------------------------------------------------------------------------- //
 
 #define TO_STDOUT TRUE
 
-#undef DEBUG
-#define DEBUG TRUE
+// Number of Worker Threads calculating a Round.
+// 1 = Calculate everything on the Main Thread (this also allows the
+//     Terminal Output to show each Cell while it is being decided)
+// 0 = Use one Worker per online CPU
+#ifndef THREADS
+    #define THREADS 1
+#endif
+// The parallel Round is also built for the Tests, which compare it with the
+// Round on the Main Thread.
+#if (THREADS != 1) || defined(TEST)
+    #define PARALLEL_ROUND TRUE
+    #include <pthread.h>
+#else
+    #define PARALLEL_ROUND FALSE
+#endif
 
+// Show the Neighbour Count of every Cell on the Board and wait for Enter
+// after every Round instead of waiting.
 #ifndef DEBUG
     #define DEBUG FALSE
 #endif
-#if DEBUG == TRUE
-    #ifndef OUTPUT_ITERATOR
-        #define OUTPUT_ITERATOR FALSE
-    #endif
-    #ifndef OUTPUT_CREATE_TEMP
-        #define OUTPUT_CREATE_TEMP FALSE
-    #endif
-    #ifndef OUTPUT_REVIVE_CELLS
-        #define OUTPUT_REVIVE_CELLS FALSE
-    #endif
-    #ifndef OUTPUT_KILL_CELLS
-        #define OUTPUT_KILL_CELLS FALSE
-    #endif
-    #ifndef OUTPUT_COMPARE
-        #define OUTPUT_COMPARE FALSE
-    #endif
-    #ifndef OUTPUT_NEIGHBOURS
-        #define OUTPUT_NEIGHBOURS FALSE
-    #endif
+
+// Delay between rounds (in ms) when the Game is displayed on the Terminal.
+// Can be changed using --delay-ms or --fps.
+#ifndef DELAY_MS
+    #define DELAY_MS 1000
 #endif
 
 // -------------------------------------------------------------------------- //
@@ -103,16 +108,38 @@
 
 // -------------------------------------------------------------------------- //
 
+// Buffer for collecting Cells before they are appended to the next
+// Generation in Bulk.
+#define STAGING_BUFFER_SIZE 256
+struct StagingBuffer {
+    struct Cell cells[STAGING_BUFFER_SIZE];
+    long num_elem;
+};
+
+// -------------------------------------------------------------------------- //
+
 int is_neighbour (struct Cell self, struct Cell other);
-void main_loop (const int steps);
+int main_loop (const int steps);
+int serial_round (bool count, struct Stats * round_stats);
 int count_set_bits(struct Cell cell);
+bool cell_dies (struct Cell * cell);
+int stage_cell (struct StagingBuffer * b, struct MemoryManager * m, struct Cell cell);
+int flush_staged_cells (struct StagingBuffer * b, struct MemoryManager * m);
+void swap_cell_buffers ();
+int count_neighbours (struct MemoryManager * cells, struct MemoryManager * temp);
 void direction_test ();
+void test_bulk_operations ();
+struct Cell * sorted_cells (struct MemoryManager * m);
+int compare_test_cells (const void * a, const void * b);
+int test_parallel_round ();
+int test_sparse ();
 int compare_cells (struct Cell * self, struct Cell * other);
 void change_pos (long * x, long * y, u8 direction);
-void create_temp_cells (struct Cell * self, u8 directions);
-void printUsage(const char* programName);
+int create_temp_cells (struct MemoryManager * temp, struct Cell * self, u8 directions);
 void create_glider(long y, long x);
 void create_gosper_gun (long y, long x);
+int dump_sparse (long generation);
+int record_cells ();
 #if TO_STDOUT == TRUE
     void setup_game_board(int height, int width);
     void resurrect_cell(u8 count, int y, int x);
@@ -124,13 +151,26 @@ void create_gosper_gun (long y, long x);
 
 // -------------------------------------------------------------------------- //
 
-// Since this is not multithreaded, I will declare these as global, so I
-// don't need to pass them down through each function.
-struct MemoryManager alive_cells = {
-    .chunks = 0 ,
-    .num_elem = 0,
-    .allocated_chunks = 0
+// These are declared globally, so I don't need to pass them down through each
+// function. The Workers of the parallel Round only ever read alive_cells and
+// keep everything else in their own MemoryManagers.
+// The alive Cells are double buffered: Each Round reads the current
+// Generation from alive_cells and writes the surviving and newborn Cells
+// sequentially into next_cells, after which the two are swapped.
+struct MemoryManager cell_buffers[2] = {
+    {
+        .chunks = 0 ,
+        .num_elem = 0,
+        .allocated_chunks = 0
+    },
+    {
+        .chunks = 0 ,
+        .num_elem = 0,
+        .allocated_chunks = 0
+    }
 };
+struct MemoryManager * alive_cells = &cell_buffers[0];
+struct MemoryManager * next_cells = &cell_buffers[1];
 
 struct MemoryManager temp_cells = {
     .chunks = 0,
@@ -138,6 +178,73 @@ struct MemoryManager temp_cells = {
     .allocated_chunks = 0
 };
 
+struct StagingBuffer staged_cells = {
+    .num_elem = 0
+};
+
+// Statistics of every Round (only used with --stats)
+// The Rounds are merged on the Main Thread, so a single Slot is enough.
+struct StatsStream stats_stream;
+
+// Coordinates of the alive Cells of every Generation (only used with --sparse)
+struct SparseStream sparse_stream;
+
+// Animated GIF of the Cells inside the Board (only used with --gif)
+struct GifWriter gif;
+
+#if PARALLEL_ROUND == TRUE
+    // State of a Worker Thread in the parallel Round.
+    // Every Worker owns a horizontal Stripe [y_begin, y_end) of the Universe
+    // and decides the Fate of all Positions inside it. For that it needs the
+    // alive Cells of the Stripe and of the Rows directly above and below it,
+    // so these Border Rows are copied into both Workers sharing them.
+    // Because the Results of the Workers never overlap, merging them only
+    // has to concatenate them.
+    // Worker 0 runs on the Main Thread, the other ones stay parked on the
+    // Barriers between the Rounds (like the Threads of scheduler.c).
+    struct Worker {
+        pthread_t thread;
+        long y_begin;
+        long y_end;
+        // Alive Cells of the Stripe including the Border Rows
+        struct MemoryManager cells;
+        // Temporary Cells around them
+        struct MemoryManager temp;
+        // Surviving and newborn Cells of the Stripe
+        struct MemoryManager next;
+        struct StagingBuffer staged;
+        // Statistics of the Stripe (with --stats)
+        struct Stats stats;
+        int result;
+    };
+
+    struct Worker * workers = NULL;
+    long num_workers = 0;
+    pthread_barrier_t worker_start;
+    pthread_barrier_t worker_done;
+    // Held while the Workers are started, so they only wait on the Barriers
+    // once it is known how many of them there are.
+    pthread_mutex_t worker_setup;
+    bool workers_stop = false;
+
+    // Sorted Rows of the alive Cells, which are split into the Stripes
+    long * stripe_rows = NULL;
+    long stripe_rows_capacity = 0;
+
+    int init_workers (long count);
+    void uninit_workers ();
+    static void free_worker_chunks (struct Worker * w);
+    int parallel_round ();
+    static int compare_rows (const void * a, const void * b);
+    void * worker_thread (void * arg);
+    void run_worker (struct Worker * w);
+    int collect_stripe (struct Worker * w);
+    int decide_stripe (struct Worker * w);
+    #if TO_STDOUT == TRUE
+        void redraw_cells (struct MemoryManager * m, void (*draw)(u8, int, int));
+    #endif
+#endif
+
 #if TO_STDOUT == TRUE
     #define Y_OFFSET 3
     #define CONS_X_OFFSET 4
@@ -216,24 +323,41 @@ const char * direction_to_string (u8 direction) {
 
 // -------------------------------------------------------------------------- //
 
-void printUsage(const char* programName) {
-    printf("usage: %s <width> <height> <density> <steps>\n", programName);
-}
-
-// -------------------------------------------------------------------------- //
-
 // TEST is set/defined via the Command Line using <gcc complicated.c -DTEST>
 #ifndef TEST
 
     int game_of_life(int argc, char* argv[]) {
 
-        if(argc != 5) {
+        if(argc < 5) {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        if (parse_options(argc, argv, &options) < 0) {
             printUsage(argv[0]);
             return EXIT_FAILURE;
         }
 
-        UNUSED(argc);
-        UNUSED(argv);
+        // Only dead Cells next to alive ones are ever looked at, so Rules
+        // where Cells are born without any Neighbours would need an
+        // infinite Board.
+        if (options.rule.next[0][0]) {
+            printf("Rules containing B0 are not supported by this Variant\n");
+            return EXIT_FAILURE;
+        }
+
+        // The Board is drawn Cell by Cell while the Generation is calculated
+        if (
+            (options.view != RENDER_CELLS) || (options.render_fps != 0) || options.render_thread ||
+            (options.frames_path != NULL)
+        ) {
+            printf("--view, --render-fps, --render-thread and --frames are not supported by this Variant\n");
+            return EXIT_FAILURE;
+        }
+        // The State of the Universe is kept in Globals
+        if ((options.batch_path != NULL) || (options.census_path != NULL)) {
+            printf("--batch and --census are only supported by the Packed Variant\n");
+            return EXIT_FAILURE;
+        }
 
         // atoi returns 0 if it could not convert the number.
         const int width = atoi(argv[1]);
@@ -250,12 +374,85 @@ void printUsage(const char* programName) {
             return EXIT_FAILURE;
         }
 
+        // Start tracing first, so the Allocation of the Chunks is traced too
+        if (start_trace(options.trace, options.trace_path) < 0) {
+            printf("Could not start the Trace\n");
+            return EXIT_FAILURE;
+        }
+
         // Initialize Chunks
-        if (init_chunks(&alive_cells) < 0) exit(1);
+        if (init_chunks(alive_cells) < 0) {
+            stop_trace();
+            return EXIT_FAILURE;
+        }
+        if (init_chunks(next_cells) < 0) {
+            deallocate_chunks(alive_cells);
+            stop_trace();
+            return EXIT_FAILURE;
+        }
         if (init_chunks(&temp_cells) < 0) {
-            deallocate_chunks(&alive_cells);
+            deallocate_chunks(alive_cells);
+            deallocate_chunks(next_cells);
+            stop_trace();
             return EXIT_FAILURE;
         };
+        #if THREADS != 1
+            if (init_workers(THREADS) < 0) {
+                deallocate_chunks(alive_cells);
+                deallocate_chunks(next_cells);
+                deallocate_chunks(&temp_cells);
+                stop_trace();
+                return EXIT_FAILURE;
+            }
+        #endif
+        if (
+            (options.stats_path != NULL) &&
+            (open_stats(&stats_stream, options.stats_path, 1) < 0)
+        ) {
+            printf("Could not open the Statistics File \"%s\"\n", options.stats_path);
+            #if THREADS != 1
+                uninit_workers();
+            #endif
+            deallocate_chunks(alive_cells);
+            deallocate_chunks(next_cells);
+            deallocate_chunks(&temp_cells);
+            stop_trace();
+            return EXIT_FAILURE;
+        }
+        if (
+            (options.sparse_path != NULL) &&
+            (open_sparse(&sparse_stream, options.sparse_path) < 0)
+        ) {
+            printf("Could not open the Sparse Dump \"%s\"\n", options.sparse_path);
+            close_sparse(&sparse_stream);
+            close_stats(&stats_stream);
+            #if THREADS != 1
+                uninit_workers();
+            #endif
+            deallocate_chunks(alive_cells);
+            deallocate_chunks(next_cells);
+            deallocate_chunks(&temp_cells);
+            stop_trace();
+            return EXIT_FAILURE;
+        }
+        // The Universe has no Bounds, so the GIF shows the Board like the
+        // Terminal does.
+        if (
+            (options.gif_path != NULL) &&
+            (open_gif(&gif, options.gif_path, width, height, options.gif_scale, options.gif_delay) < 0)
+        ) {
+            printf("Could not create the GIF \"%s\"\n", options.gif_path);
+            close_sparse(&sparse_stream);
+            close_stats(&stats_stream);
+            #if THREADS != 1
+                uninit_workers();
+            #endif
+            deallocate_chunks(alive_cells);
+            deallocate_chunks(next_cells);
+            deallocate_chunks(&temp_cells);
+            stop_trace();
+            return EXIT_FAILURE;
+        }
 
         #if TO_STDOUT == TRUE
             board_height = height;
@@ -264,18 +461,18 @@ void printUsage(const char* programName) {
         #endif
 
         // Create some Patterns
-        add_elem(&alive_cells, alive(1, 2));
-        add_elem(&alive_cells, alive(1, 3));
-        add_elem(&alive_cells, alive(1, 4));
+        add_elem(alive_cells, alive(1, 2));
+        add_elem(alive_cells, alive(1, 3));
+        add_elem(alive_cells, alive(1, 4));
 
-        add_elem(&alive_cells, alive(10, 4));
-        add_elem(&alive_cells, alive(10, 5));
-        add_elem(&alive_cells, alive(10, 6));
+        add_elem(alive_cells, alive(10, 4));
+        add_elem(alive_cells, alive(10, 5));
+        add_elem(alive_cells, alive(10, 6));
 
-        add_elem(&alive_cells, alive(17, 4));
-        add_elem(&alive_cells, alive(17, 5));
-        add_elem(&alive_cells, alive(18, 4));
-        add_elem(&alive_cells, alive(18, 5));
+        add_elem(alive_cells, alive(17, 4));
+        add_elem(alive_cells, alive(17, 5));
+        add_elem(alive_cells, alive(18, 4));
+        add_elem(alive_cells, alive(18, 5));
 
         create_glider(5,25);
         create_glider(5,35);
@@ -289,18 +486,33 @@ void printUsage(const char* programName) {
 
         // create_gosper_gun(10, -10);
 
-        main_loop(steps);
+        int result = main_loop(steps);
 
         #if TO_STDOUT == TRUE
             // Restore Terminal Output and show the cursor again
             printf("\x1B[?1049l\x1B[?25h");
         #endif
 
+        if (close_gif(&gif) < 0) {
+            printf("Could not write the GIF \"%s\"\n", options.gif_path);
+            result = -1;
+        }
+        if (close_sparse(&sparse_stream) < 0) {
+            printf("Could not write the Sparse Dump \"%s\"\n", options.sparse_path);
+            result = -1;
+        }
+        close_stats(&stats_stream);
+
         // Safely deallocate Chunks
-        deallocate_chunks(&alive_cells);
+        #if THREADS != 1
+            uninit_workers();
+        #endif
+        deallocate_chunks(alive_cells);
+        deallocate_chunks(next_cells);
         deallocate_chunks(&temp_cells);
+        stop_trace();
 
-        return EXIT_SUCCESS;
+        return (result < 0) ? EXIT_FAILURE : EXIT_SUCCESS;
 
     }
 
@@ -314,17 +526,22 @@ void printUsage(const char* programName) {
 
         direction_test();
 
-        if (init_chunks(&alive_cells) < 0) exit(1);
+        if (init_chunks(alive_cells) < 0) exit(1);
+        if (init_chunks(next_cells) < 0) {
+            deallocate_chunks(alive_cells);
+            exit(1);
+        }
         if (init_chunks(&temp_cells) < 0) {
-            deallocate_chunks(&alive_cells);
+            deallocate_chunks(alive_cells);
+            deallocate_chunks(next_cells);
             exit(1);
         };
 
         for (int i = 0; i < 21; i++) {
-            add_elem(&alive_cells, new_cell(i, i * 2));
+            add_elem(alive_cells, new_cell(i, i * 2));
         }
 
-        struct MemoryIterator i = Iter.iter(&alive_cells);
+        struct MemoryIterator i = Iter.iter(alive_cells);
         struct Cell * p = Iter.peek(&i);
         struct Cell * c = Iter.next(&i);
 
@@ -338,7 +555,7 @@ void printUsage(const char* programName) {
         printf(RED "Removing Cells\n");
 
         for (int i = 0; i < 11; i++) {
-            remove_elem(&alive_cells, 0);
+            remove_elem(alive_cells, 0);
         }
 
         c = Iter.next(&i);
@@ -348,10 +565,286 @@ void printUsage(const char* programName) {
             c = Iter.next(&i);
         }
 
-        deallocate_chunks(&alive_cells);
+        test_bulk_operations();
+        int errors = test_parallel_round();
+        errors += test_sparse();
+
+        deallocate_chunks(alive_cells);
+        deallocate_chunks(next_cells);
         deallocate_chunks(&temp_cells);
 
+        return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+
+    }
+
+// -------------------------------------------------------------------------- //
+
+    // Predicate for test_bulk_operations => Remove Cells with an odd y
+    bool odd_row (struct Cell * cell) {
+        return cell->y % 2;
+    }
+
+    // Tests for add_elems and remove_elems_if spanning multiple Chunks
+    void test_bulk_operations () {
+
+        printf(RED "Bulk Operations\n" DEFAULT);
+
+        reset(alive_cells);
+
+        // Enough Cells to fill a few Chunks
+        long count = CHUNK_SIZE * 2 + 10;
+        struct Cell * cells = malloc(sizeof(struct Cell) * count);
+        if (cells == NULL) return;
+        for (long i = 0; i < count; i++) {
+            cells[i] = new_cell(i, i * 2);
+        }
+
+        // Append in two Parts so the second one starts in the middle of a Chunk
+        add_elems(alive_cells, cells, 10);
+        add_elems(alive_cells, cells + 10, count - 10);
+        printf("\tAdded %ld Cells in %ld Chunks\n",
+            alive_cells->num_elem, alive_cells->allocated_chunks
+        );
+
+        long removed = remove_elems_if(alive_cells, odd_row);
+        printf("\tRemoved %ld Cells => %ld Cells in %ld Chunks\n",
+            removed, alive_cells->num_elem, alive_cells->allocated_chunks
+        );
+
+        // The remaining Cells have to keep their Order
+        struct MemoryIterator i = Iter.iter(alive_cells);
+        struct Cell * c = Iter.next(&i);
+        long expected = 0;
+        while (c != NULL) {
+            if (c->y != expected) {
+                printf("\t" RED "Unexpected Cell (%ld, %ld) instead of y = %ld\n" DEFAULT,
+                    c->y, c->x, expected
+                );
+                break;
+            }
+            expected += 2;
+            c = Iter.next(&i);
+        }
+        printf("\tChecked %ld remaining Cells\n", expected / 2);
+
+        // The Spans have to return the same Cells, one Chunk at a Time
+        i = Iter.iter(alive_cells);
+        struct MemorySpan span = Iter.next_span(&i);
+        long spans = 0;
+        expected = 0;
+        while (span.len > 0) {
+            for (long iLauf = 0; iLauf < span.len; iLauf ++) {
+                if (span.elems[iLauf].y != expected) {
+                    printf("\t" RED "Unexpected Span Cell (%ld, %ld) instead of y = %ld\n" DEFAULT,
+                        span.elems[iLauf].y, span.elems[iLauf].x, expected
+                    );
+                    break;
+                }
+                expected += 2;
+            }
+            spans ++;
+            span = Iter.next_span(&i);
+        }
+        printf("\tChecked %ld remaining Cells in %ld Spans\n", expected / 2, spans);
+
+        free(cells);
+
+    }
+
+// -------------------------------------------------------------------------- //
+
+    // Copy the Cells of a MemoryManager sorted by Row and Column, so
+    // Generations can be compared no Matter in which Order they were written.
+    struct Cell * sorted_cells (struct MemoryManager * m) {
+        struct Cell * cells = malloc(sizeof(struct Cell) * (m->num_elem + 1));
+        if (cells == NULL) return NULL;
+        long count = 0;
+        struct MemoryIterator i = Iter.iter(m);
+        struct MemorySpan span = Iter.next_span(&i);
+        while (span.len > 0) {
+            memcpy(cells + count, span.elems, sizeof(struct Cell) * span.len);
+            count += span.len;
+            span = Iter.next_span(&i);
+        }
+        qsort(cells, count, sizeof(struct Cell), compare_test_cells);
+        return cells;
+    }
+
+    int compare_test_cells (const void * a, const void * b) {
+        const struct Cell * self = a;
+        const struct Cell * other = b;
+        if (self->y != other->y) return (self->y < other->y) ? -1 : 1;
+        if (self->x != other->x) return (self->x < other->x) ? -1 : 1;
         return 0;
+    }
+
+    // Compare the parallel Round with the Round on the Main Thread on a
+    // random Soup and a Glider far away from it, which puts most Rows of the
+    // Universe between them.
+    // Returns the Number of failed Rules.
+    int test_parallel_round () {
+
+        const char * rules[] = {"B3/S23", "B36/S23"};
+        const int steps = 40;
+        int errors = 0;
+
+        printf(RED "Parallel Round\n" DEFAULT);
+
+        if (init_workers(4) < 0) return 1;
+
+        for (unsigned iRule = 0; iRule < (sizeof(rules) / sizeof(rules[0])); iRule ++) {
+            parse_rule(rules[iRule], &options.rule);
+            reset(alive_cells);
+            reset(next_cells);
+            reset(&temp_cells);
+
+            srand(42);
+            for (long iLauf = 0; iLauf < 20; iLauf ++) {
+                for (long iLauf2 = 0; iLauf2 < 20; iLauf2 ++) {
+                    if ((rand() % 3) == 0) add_elem(alive_cells, new_cell(iLauf, iLauf2));
+                }
+            }
+            create_glider(-500, 0);
+
+            long mismatches = 0;
+            struct Stats stats;
+            for (int iStep = 0; (iStep < steps) && (alive_cells->num_elem > 0); iStep ++) {
+                reset_stats(&stats);
+                // Running out of Memory counts as a Failure as well
+                struct Cell * expected = NULL;
+                struct Cell * cells = NULL;
+                long expected_count = 0;
+                if (serial_round(false, &stats) == 0) {
+                    expected = sorted_cells(next_cells);
+                    expected_count = next_cells->num_elem;
+                }
+                reset(next_cells);
+                reset(&temp_cells);
+                if ((expected != NULL) && (parallel_round() == 0)) {
+                    cells = sorted_cells(next_cells);
+                }
+                if (cells == NULL) {
+                    free(expected);
+                    mismatches ++;
+                    break;
+                }
+                if (next_cells->num_elem != expected_count) {
+                    mismatches ++;
+                } else {
+                    for (long iLauf = 0; iLauf < expected_count; iLauf ++) {
+                        if (compare_test_cells(&cells[iLauf], &expected[iLauf]) != 0) {
+                            mismatches ++;
+                            break;
+                        }
+                    }
+                }
+                free(cells);
+                free(expected);
+                reset(alive_cells);
+                swap_cell_buffers();
+            }
+
+            printf(
+                "\t%-8s %ld Workers, %d Generations: %s\n", rules[iRule], num_workers, steps,
+                mismatches ? RED "FAILED" DEFAULT : GREEN "OK" DEFAULT
+            );
+            if (mismatches) errors ++;
+        }
+
+        uninit_workers();
+        parse_rule("B3/S23", &options.rule);
+
+        return errors;
+
+    }
+
+// -------------------------------------------------------------------------- //
+
+    // Dump some Generations of Cells around the Origin (so with negative
+    // Coordinates) and an empty Generation, read them back and compare them
+    // with the alive Cells.
+    // Returns 1 if the Test failed.
+    int test_sparse () {
+
+        const char * path = "test_sparse.gols";
+        // The last Generation is empty
+        #define SPARSE_TEST_GENERATIONS 8
+        struct Cell * expected[SPARSE_TEST_GENERATIONS] = {NULL};
+        long counts[SPARSE_TEST_GENERATIONS] = {0};
+        int errors = 0;
+
+        printf(RED "Sparse Dump\n" DEFAULT);
+
+        reset(alive_cells);
+        reset(next_cells);
+        reset(&temp_cells);
+        srand(7);
+        for (long iLauf = -10; iLauf < 10; iLauf ++) {
+            for (long iLauf2 = -10; iLauf2 < 10; iLauf2 ++) {
+                if ((rand() % 3) == 0) add_elem(alive_cells, new_cell(iLauf, iLauf2));
+            }
+        }
+        create_glider(-300, -4000);
+
+        if (open_sparse(&sparse_stream, path) < 0) errors = 1;
+        for (int iLauf = 0; (errors == 0) && (iLauf < SPARSE_TEST_GENERATIONS); iLauf ++) {
+            if (iLauf == (SPARSE_TEST_GENERATIONS - 1)) reset(alive_cells);
+            expected[iLauf] = sorted_cells(alive_cells);
+            counts[iLauf] = alive_cells->num_elem;
+            if ((expected[iLauf] == NULL) || (dump_sparse(iLauf) < 0)) {
+                errors = 1;
+                break;
+            }
+            struct Stats stats;
+            reset_stats(&stats);
+            if (serial_round(false, &stats) < 0) errors = 1;
+            reset(alive_cells);
+            reset(&temp_cells);
+            swap_cell_buffers();
+        }
+        if (close_sparse(&sparse_stream) < 0) errors = 1;
+
+        FILE * file = fopen(path, "rb");
+        if ((errors == 0) && (file != NULL) && (read_sparse_header(file) == 0)) {
+            struct SparseCell * cells = NULL;
+            long count = 0, capacity = 0, generation = 0;
+            for (int iLauf = 0; iLauf < SPARSE_TEST_GENERATIONS; iLauf ++) {
+                if (
+                    (read_sparse(file, &generation, &cells, &count, &capacity) != 0) ||
+                    (generation != iLauf) || (count != counts[iLauf])
+                ) {
+                    errors = 1;
+                    break;
+                }
+                for (long iLauf2 = 0; iLauf2 < count; iLauf2 ++) {
+                    if (
+                        (cells[iLauf2].y != expected[iLauf][iLauf2].y) ||
+                        (cells[iLauf2].x != expected[iLauf][iLauf2].x)
+                    ) {
+                        errors = 1;
+                    }
+                }
+            }
+            // Nothing may follow the last Generation
+            if ((errors == 0) && (read_sparse(file, &generation, &cells, &count, &capacity) != 1)) {
+                errors = 1;
+            }
+            free(cells);
+        } else {
+            errors = 1;
+        }
+        if (file != NULL) fclose(file);
+
+        printf(
+            "\t%d Generations: %s\n", SPARSE_TEST_GENERATIONS,
+            errors ? RED "FAILED" DEFAULT : GREEN "OK" DEFAULT
+        );
+
+        remove(path);
+        for (int iLauf = 0; iLauf < SPARSE_TEST_GENERATIONS; iLauf ++) free(expected[iLauf]);
+        #undef SPARSE_TEST_GENERATIONS
+
+        return errors;
 
     }
 
@@ -393,32 +886,46 @@ void printUsage(const char* programName) {
 
 // -------------------------------------------------------------------------- //
 
-void main_loop (const int steps) {
+// Returns -1 if no more Memory could be allocated or the Statistics, the
+// Sparse Dump or the GIF could not be written.
+int main_loop (const int steps) {
 
     // Variable Declarations
 
-    struct MemoryIterator curr_iter, alive_iterator;
-    // NOTE: Why tf do I need the second "*"?
-    //       Why does it not assume that both are Pointers?
-    struct Cell * curr_cell, * cmp_cell;
-
-    // Keep Track of the current Cells neighbours
-    u8 curr_neighbours;
-    // Helper Variable for storing Directions.
-    int direction;
-    // Helper Variable for counting Direction Bits.
-    int num_bits;
+    struct MemoryIterator curr_iter;
+    struct Cell * curr_cell;
 
     // Keep Track of the number of rounds already elapsed.
     int step_counter = 0;
 
+    // Count the Statistics of the Round (with --stats)
+    const bool count = stats_stream.file != NULL;
+    struct Stats round_stats;
+
+    // Dump every Generation including the first one (with --sparse)
+    const bool dump = sparse_stream.file != NULL;
+    if (dump && (dump_sparse(0) < 0)) {
+        PRINT(RED "ERROR: Could not write the Sparse Dump");
+        return -1;
+    }
+    if (record_cells() < 0) {
+        PRINT(RED "ERROR: Could not write the GIF");
+        return -1;
+    }
+
+    // Pace the Rounds (only if they are shown on the Terminal, unless a Rate
+    // was given)
+    struct Pacer pacer;
+    #if TO_STDOUT == TRUE
+        init_pacer(&pacer, pace_interval(&options, DELAY_MS));
+    #else
+        init_pacer(&pacer, pace_interval(&options, 0));
+    #endif
+
 // -------------------------------------------------------------------------- //
 
     // Keep looping until no more Cells are alive or until the Step Limit is reached
-    while ((alive_cells.num_elem > 0) && (step_counter < steps)) {
-        // Setup Memory Iterators
-        alive_iterator = Iter.iter(&alive_cells);
-        curr_cell = Iter.next(&alive_iterator);
+    while ((alive_cells->num_elem > 0) && (step_counter < steps)) {
         // Start new Round
         step_counter ++;
         #if TO_STDOUT == TRUE
@@ -426,149 +933,86 @@ void main_loop (const int steps) {
         #else
             printf(RED "\nRound %d:\n" DEFAULT, step_counter);
         #endif
+        reset_stats(&round_stats);
+        PROFILE_TIMER(reset);
 
-// -------------------------------------------------------------------------- //
+#if THREADS != 1
 
-        // Calculate Neighbours for all alive Cells
-        while (curr_cell != NULL) {
-            // Reset Alive Cell Iterator
-            curr_iter = alive_iterator;
-            cmp_cell = Iter.next(&curr_iter);
-            // Get the current Cells Neighbour Count (reset when checking if Cell is alive)
-            curr_neighbours = curr_cell->neighbours;
-            #if OUTPUT_ITERATOR == TRUE
-                PRINT(GREEN "Current Cell (%ld): %p (%ld, %ld)\n", alive_iterator.curr_idx, curr_cell, curr_cell->y, curr_cell->x);
-            #endif
-            while (cmp_cell != NULL) {
-                #if OUTPUT_COMPARE == TRUE
-                    PRINT(YELLOW "\tCompare Cell: %p (%ld, %ld)\n", cmp_cell ,cmp_cell->y, cmp_cell->x);
-                #endif
-                // Compare Cells
-                if ((direction = compare_cells(curr_cell, cmp_cell)) == -1) {
-                    // Cells are neighbours so remove the later one.
-                    // NOTE: This should not be able to happen so just print
-                    //       an Error Message.
-                    fprintf(stderr, BG_RED BLUE "There are two identical Cells at : (%ld, %ld)\n" DEFAULT, curr_cell->y, curr_cell->x);
-                } else {
-                    // Cells are Neighbours
-                    // => Set the corresponding Direction Bit in the
-                    //    neighbours-Field
-                    SET_BITS(curr_cell->neighbours, direction);
-                    SET_BITS(cmp_cell->neighbours, reverse_direction(direction));
-                    // Add Direction to the current Cells Neighbour Variable
-                    curr_neighbours |= direction;
-                }
-                cmp_cell = Iter.next(&curr_iter);
-            }
+        // Let the Workers calculate the next Generation
+        if (parallel_round() < 0) {
+            PRINT(RED "ERROR: No more Memory");
+            return -1;
+        }
 
-// -------------------------------------------------------------------------- //
+        #if TO_STDOUT == TRUE
+            // The Workers cannot draw on the Terminal themselves, so the
+            // Board is redrawn once the Round is complete.
+            redraw_cells(alive_cells, kill_cell);
+            redraw_cells(next_cells, alive_cell);
+        #endif
 
-            // Loop through all Temporary Cells
-            curr_iter = Iter.iter(&temp_cells);
-            cmp_cell = Iter.next(&curr_iter);
-            while (cmp_cell != NULL) {
-                #if OUTPUT_COMPARE == TRUE
-                    PRINT(YELLOW "\tCompare Cell: %p (%ld, %ld)\n", cmp_cell ,cmp_cell->y, cmp_cell->x);
-                #endif
-                // Compare Cells
-                if ((direction = compare_cells(curr_cell, cmp_cell)) == -1) {
-                    // Cells are neighbours so remove the later one.
-                    // NOTE: This should not be able to happen so just print
-                    //       an Error Message.
-                    fprintf(stderr, BG_RED BLUE "There are two identical Cells at : (%ld, %ld)\n" DEFAULT, curr_cell->y, curr_cell->x);
-                } else {
-                    // Cells are Neighbours
-                    // Because these Cells are not alive, only in consideration
-                    // don't set the Direction Bit in the original (alive) Cell
-                    // => Set the corresponding Direction Bit in the
-                    //    neighbours-Field
-                    SET_BITS(cmp_cell->neighbours, reverse_direction(direction));
-                    // Add Direction to the current Cells Neighbour Variable
-                    curr_neighbours |= direction;
-                }
-                cmp_cell = Iter.next(&curr_iter);
+        // Every Stripe counts as a Tile
+        if (count) {
+            for (long iLauf = 0; iLauf < num_workers; iLauf ++) {
+                add_tile_stats(&round_stats, &workers[iLauf].stats);
             }
-            // Create Temporary Cells around the current Cell.
-            create_temp_cells(curr_cell, curr_neighbours);
-            // Get next Cell
-            curr_cell = Iter.next(&alive_iterator);
         }
 
-// -------------------------------------------------------------------------- //
+        // The next Generation is complete, so the old one can be dropped and
+        // the Buffers swapped.
+        reset(alive_cells);
+        swap_cell_buffers();
 
-        // Check which alive Cells stay alive
-        curr_iter = Iter.iter(&alive_cells);
-        curr_cell = Iter.next(&curr_iter);
-        while (curr_cell != NULL) {
-            num_bits = count_set_bits(*curr_cell);
-            if ((num_bits == 2) || (num_bits == 3)) {
-                #if TO_STDOUT == TRUE
-                    resurrect_cell(num_bits, curr_cell->y, curr_cell->x);
-                #endif
-                #if OUTPUT_REVIVE_CELLS == TRUE
-                    PRINT(GREEN "\t\tSurviving Cell: (%ld, %ld) %d\n", curr_cell->y, curr_cell->x, num_bits);
-                #endif
-                // Reset Cells Neighbour Count
-                curr_cell->neighbours = 0;
-                // Get the next Cell
-                curr_cell = Iter.next(&curr_iter);
-            } else {
-                #if TO_STDOUT == TRUE
-                    dying_cell(num_bits, curr_cell->y, curr_cell->x);
-                #endif
-                #if OUTPUT_REVIVE_CELLS == TRUE
-                    PRINT(BLUE "\t\tDying Cell: (%ld, %ld) %d\n", curr_cell->y, curr_cell->x, num_bits);
-                #endif
-                // Unalive the Cell
-                remove_elem(&alive_cells, curr_iter.curr_idx - 1);
-                // Get the Cell at the same place which replaced the old one
-                curr_cell = Iter.previous(&curr_iter);
-            }
+#else
+
+        // Calculate the next Generation on this Thread
+        if (serial_round(count, &round_stats) < 0) {
+            PRINT(RED "ERROR: No more Memory");
+            return -1;
         }
 
-// -------------------------------------------------------------------------- //
+        // The next Generation is complete, so the old one can be dropped and
+        // the Buffers swapped.
+        reset(alive_cells);
+        swap_cell_buffers();
 
-        // Check which temporary Cells will resurrect
-        curr_iter = Iter.iter(&temp_cells);
-        curr_cell = Iter.next(&curr_iter);
-        while (curr_cell != NULL) {
-            num_bits = count_set_bits(*curr_cell);
-            if (num_bits == 3) {
-                #if TO_STDOUT == TRUE
-                    alive_cell(num_bits, curr_cell->y, curr_cell->x);
-                #endif
-                #if OUTPUT_REVIVE_CELLS
-                    PRINT(GREEN "\t\tRessurecting Cell (%ld, %ld) %d\n", curr_cell->y, curr_cell->x, num_bits);
-                #endif
-                // Reset Cells Neighbour Count
-                curr_cell->neighbours = 0;
-                // Add the Cell to the Alive Cells => Resurrect it
-                if (add_elem(&alive_cells, *curr_cell) < 0) {
-                    PRINT(RED "ERROR: No more Memory");
-                    return;
-                }
-            } else {
-                #if TO_STDOUT == TRUE
-                    temp_cell(num_bits, curr_cell->y, curr_cell->x);
-                #endif
+#endif
+
+        if (count) {
+            merge_stats(&stats_stream.slots[0], &round_stats);
+            if (write_stats(&stats_stream, step_counter) < 0) {
+                PRINT(RED "ERROR: Could not write the Statistics");
+                return -1;
             }
-            curr_cell = Iter.next(&curr_iter);
+        }
+        if (dump && (dump_sparse(step_counter) < 0)) {
+            PRINT(RED "ERROR: Could not write the Sparse Dump");
+            return -1;
+        }
+        if (record_cells() < 0) {
+            PRINT(RED "ERROR: Could not write the GIF");
+            return -1;
         }
 
-        #if TO_STDOUT == TRUE
-            #if DEBUG == TRUE
+        #if (TO_STDOUT == TRUE) && (DEBUG == TRUE)
+            // Wait for Enter, unless a Rate was given
+            if (options.delay < 0) {
                 getchar();
-            #else
-                sleep(1);
-            #endif
+            } else {
+                pace(&pacer);
+            }
+        #else
+            pace(&pacer);
         #endif
 
+        PROFILE_START(reset);
         #if TO_STDOUT == TRUE
             // Reset the Console
             while (curr_row > Y_OFFSET) {
                 printf("\x1B[%d;%dH" CLEAR_TO_EOL, curr_row--, board_width + CONS_X_OFFSET);
             }
             // Remove the Temporary Cells which didn't resurrect
+            // (The parallel Round does not use them)
             curr_iter = Iter.iter(&temp_cells);
             curr_cell = Iter.next(&curr_iter);
             while (curr_cell != NULL) {
@@ -579,9 +1023,238 @@ void main_loop (const int steps) {
 
         // Reset Temporary Cells
         reset(&temp_cells);
+        PROFILE_STOP(reset);
+        PROFILE_FLUSH(reset);
+
+        PROFILE_GENERATION();
+
+    }
+
+    return 0;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Calculate the next Generation of alive_cells into next_cells on the Main
+// Thread, drawing every Cell on the Terminal while it is decided.
+// The temporary Cells stay in temp_cells, so they can be removed from the
+// Terminal once the Round was shown.
+// Returns -1 if no more Memory could be allocated.
+int serial_round (bool count, struct Stats * round_stats) {
+
+    struct MemoryIterator curr_iter;
+    struct Cell * curr_cell;
+
+    PROFILE_TIMER(survive);
+    PROFILE_TIMER(resurrect);
+
+    // Calculate Neighbours for all alive Cells
+    if (count_neighbours(alive_cells, &temp_cells) < 0) return -1;
+
+    // Write the surviving Cells into the next Generation
+    PROFILE_START(survive);
+    curr_iter = Iter.iter(alive_cells);
+    struct MemorySpan span = Iter.next_span(&curr_iter);
+    while (span.len > 0) {
+        for (long iLauf = 0; iLauf < span.len; iLauf ++) {
+            curr_cell = &span.elems[iLauf];
+            bool dies = cell_dies(curr_cell);
+            if (count) count_cell(round_stats, true, !dies, curr_cell->x, curr_cell->y);
+            if (!dies && (stage_cell(&staged_cells, next_cells, *curr_cell) < 0)) return -1;
+        }
+        span = Iter.next_span(&curr_iter);
+    }
+    PROFILE_STOP(survive);
+    PROFILE_FLUSH(survive);
+
+    // Check which temporary Cells will resurrect and write them into the
+    // next Generation as well.
+    PROFILE_START(resurrect);
+    int num_bits;
+    curr_iter = Iter.iter(&temp_cells);
+    curr_cell = Iter.next(&curr_iter);
+    while (curr_cell != NULL) {
+        num_bits = count_set_bits(*curr_cell);
+        if (options.rule.next[0][num_bits]) {
+            #if TO_STDOUT == TRUE
+                alive_cell(num_bits, curr_cell->y, curr_cell->x);
+            #endif
+            TRACE(REVIVE, "Ressurecting Cell (%ld, %ld) %ld", curr_cell->y, curr_cell->x, num_bits);
+            if (count) count_cell(round_stats, false, true, curr_cell->x, curr_cell->y);
+            // Add the Cell to the next Generation => Resurrect it
+            if (stage_cell(&staged_cells, next_cells, *curr_cell) < 0) return -1;
+        } else {
+            #if TO_STDOUT == TRUE
+                temp_cell(num_bits, curr_cell->y, curr_cell->x);
+            #endif
+        }
+        curr_cell = Iter.next(&curr_iter);
+    }
+    // Add the remaining Cells
+    if (flush_staged_cells(&staged_cells, next_cells) < 0) return -1;
+    PROFILE_STOP(resurrect);
+    PROFILE_FLUSH(resurrect);
+
+    // The whole Universe is a single Tile
+    round_stats->active_tiles = (round_stats->births + round_stats->deaths) > 0;
+
+    return 0;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Calculate the Neighbours of all Cells in the MemoryManager cells by
+// comparing them with each other and create a temporary Cell in temp for every
+// free Position around them, which then holds the Neighbours of that Position.
+// Returns -1 if no more Memory could be allocated.
+int count_neighbours (struct MemoryManager * cells, struct MemoryManager * temp) {
+
+    struct MemoryIterator curr_iter;
+    struct MemoryIterator alive_iterator = Iter.iter(cells);
+    // NOTE: Why tf do I need the second "*"?
+    //       Why does it not assume that both are Pointers?
+    struct Cell * curr_cell = Iter.next(&alive_iterator);
+    struct Cell * cmp_cell;
+
+    // Keep Track of the current Cells neighbours
+    u8 curr_neighbours;
+    // Helper Variable for storing Directions.
+    int direction;
+
+    PROFILE_TIMER(compare);
+    PROFILE_TIMER(temp);
+    #if PROFILE == TRUE
+        long comparisons = 0;
+        long initial_temps = temp->num_elem;
+    #endif
+
+    while (curr_cell != NULL) {
+        PROFILE_START(compare);
+        // Reset Alive Cell Iterator
+        curr_iter = alive_iterator;
+        cmp_cell = Iter.next(&curr_iter);
+        // Get the current Cells Neighbour Count (reset when checking if Cell is alive)
+        curr_neighbours = curr_cell->neighbours;
+        TRACE(ITERATOR, "Current Cell (%ld): %#lx (%ld, %ld)", alive_iterator.curr_idx, curr_cell, curr_cell->y, curr_cell->x);
+        while (cmp_cell != NULL) {
+            TRACE(COMPARE, "Compare Cell: %#lx (%ld, %ld)", cmp_cell, cmp_cell->y, cmp_cell->x);
+            #if PROFILE == TRUE
+                comparisons ++;
+            #endif
+            // Compare Cells
+            if ((direction = compare_cells(curr_cell, cmp_cell)) == -1) {
+                // Cells are neighbours so remove the later one.
+                // NOTE: This should not be able to happen so just print
+                //       an Error Message.
+                fprintf(stderr, BG_RED BLUE "There are two identical Cells at : (%ld, %ld)\n" DEFAULT, curr_cell->y, curr_cell->x);
+            } else {
+                // Cells are Neighbours
+                // => Set the corresponding Direction Bit in the
+                //    neighbours-Field
+                SET_BITS(curr_cell->neighbours, direction);
+                SET_BITS(cmp_cell->neighbours, reverse_direction(direction));
+                // Add Direction to the current Cells Neighbour Variable
+                curr_neighbours |= direction;
+            }
+            cmp_cell = Iter.next(&curr_iter);
+        }
+
+// -------------------------------------------------------------------------- //
+
+        // Loop through all Temporary Cells
+        curr_iter = Iter.iter(temp);
+        cmp_cell = Iter.next(&curr_iter);
+        while (cmp_cell != NULL) {
+            TRACE(COMPARE, "Compare Cell: %#lx (%ld, %ld)", cmp_cell, cmp_cell->y, cmp_cell->x);
+            #if PROFILE == TRUE
+                comparisons ++;
+            #endif
+            // Compare Cells
+            if ((direction = compare_cells(curr_cell, cmp_cell)) == -1) {
+                // Cells are neighbours so remove the later one.
+                // NOTE: This should not be able to happen so just print
+                //       an Error Message.
+                fprintf(stderr, BG_RED BLUE "There are two identical Cells at : (%ld, %ld)\n" DEFAULT, curr_cell->y, curr_cell->x);
+            } else {
+                // Cells are Neighbours
+                // Because these Cells are not alive, only in consideration
+                // don't set the Direction Bit in the original (alive) Cell
+                // => Set the corresponding Direction Bit in the
+                //    neighbours-Field
+                SET_BITS(cmp_cell->neighbours, reverse_direction(direction));
+                // Add Direction to the current Cells Neighbour Variable
+                curr_neighbours |= direction;
+            }
+            cmp_cell = Iter.next(&curr_iter);
+        }
+        PROFILE_STOP(compare);
+        // Create Temporary Cells around the current Cell.
+        PROFILE_START(temp);
+        if (create_temp_cells(temp, curr_cell, curr_neighbours) < 0) return -1;
+        PROFILE_STOP(temp);
+        // Get next Cell
+        curr_cell = Iter.next(&alive_iterator);
+    }
+
+    PROFILE_FLUSH(compare);
+    PROFILE_FLUSH(temp);
+    PROFILE_COUNT(comparisons, comparisons);
+    PROFILE_COUNT(temp_cells, temp->num_elem - initial_temps);
+
+    return 0;
+
+}
+
+// -------------------------------------------------------------------------- //
 
+// Check if an alive Cell dies in this Round.
+bool cell_dies (struct Cell * cell) {
+    int num_bits = count_set_bits(*cell);
+    if (options.rule.next[1][num_bits]) {
+        #if TO_STDOUT == TRUE
+            resurrect_cell(num_bits, cell->y, cell->x);
+        #endif
+        TRACE(REVIVE, "Surviving Cell: (%ld, %ld) %ld", cell->y, cell->x, num_bits);
+        return false;
     }
+    #if TO_STDOUT == TRUE
+        dying_cell(num_bits, cell->y, cell->x);
+    #endif
+    TRACE(KILL, "Dying Cell: (%ld, %ld) %ld", cell->y, cell->x, num_bits);
+    // Unalive the Cell
+    return true;
+}
+
+// -------------------------------------------------------------------------- //
+
+// Queue a Cell for the MemoryManager m with a reset Neighbour Count.
+// The Cells are only copied into m in Bulk once the Staging Buffer b is full,
+// so flush_staged_cells has to be called once all Cells are staged.
+// Returns -1 if no more Memory could be allocated.
+int stage_cell (struct StagingBuffer * b, struct MemoryManager * m, struct Cell cell) {
+    cell.neighbours = 0;
+    b->cells[b->num_elem++] = cell;
+    if (b->num_elem == STAGING_BUFFER_SIZE)
+        return flush_staged_cells(b, m);
+    return 0;
+}
 
+// Append all Cells staged in b to the MemoryManager m.
+int flush_staged_cells (struct StagingBuffer * b, struct MemoryManager * m) {
+    long count = b->num_elem;
+    b->num_elem = 0;
+    return add_elems(m, b->cells, count);
+}
+
+// -------------------------------------------------------------------------- //
+
+// Make the next Generation the current one.
+void swap_cell_buffers () {
+    struct MemoryManager * temp = alive_cells;
+    alive_cells = next_cells;
+    next_cells = temp;
 }
 
 // -------------------------------------------------------------------------- //
@@ -602,13 +1275,7 @@ int compare_cells (struct Cell * self, struct Cell * other) {
             return -1;
         default:
             // Cells are neighbours
-            #if OUTPUT_NEIGHBOURS == TRUE
-                PRINT(BLUE "\t\tNeighbours: (%ld, %ld) (%ld, %ld) : %s => %s\n",
-                    self->y, self->x, other->y, other->x,
-                    direction_to_string(neighbour),
-                    direction_to_string(reverse_direction(neighbour))
-                );
-            #endif
+            TRACE(NEIGHBOURS, "Neighbours: (%ld, %ld) (%ld, %ld)", self->y, self->x, other->y, other->x);
             return neighbour;
     }
 }
@@ -616,7 +1283,8 @@ int compare_cells (struct Cell * self, struct Cell * other) {
 // -------------------------------------------------------------------------- //
 
 // Create all temporary Cells around the Cell self which didn't already exist
-void create_temp_cells (struct Cell * self, u8 directions) {
+// Returns -1 if no more Memory could be allocated.
+int create_temp_cells (struct MemoryManager * temp, struct Cell * self, u8 directions) {
 
     int bitmask = 1;
     u8 reverse;
@@ -643,14 +1311,9 @@ void create_temp_cells (struct Cell * self, u8 directions) {
             // Set the Neighbour Field in that Cell
             c.neighbours = reverse;
 
-            if (add_elem(&temp_cells, c) == -1) {
-                PRINT(RED "ERROR: No more Memory");
-                return;
-            }
+            if (add_elem(temp, c) == -1) return -1;
 
-            #if OUTPUT_CREATE_TEMP == TRUE
-                PRINT(GREEN "\t\t\tCreating Temp Cell at (%ld, %ld)\n", y, x);
-            #endif
+            TRACE(CREATE_TEMP, "Creating Temp Cell at (%ld, %ld)", y, x);
 
         }
 
@@ -658,6 +1321,8 @@ void create_temp_cells (struct Cell * self, u8 directions) {
 
     }
 
+    return 0;
+
 }
 
 // -------------------------------------------------------------------------- //
@@ -766,7 +1431,7 @@ int count_set_bits(struct Cell cell) {
             printf("\n");
         }
         // Print initial Cells
-        struct MemoryIterator alive_iterator = Iter.iter(&alive_cells);
+        struct MemoryIterator alive_iterator = Iter.iter(alive_cells);
         struct Cell * c = Iter.next(&alive_iterator);
         while (c != NULL) {
             if (
@@ -845,12 +1510,277 @@ int count_set_bits(struct Cell cell) {
 
 // -------------------------------------------------------------------------- //
 
+#if PARALLEL_ROUND == TRUE
+
+    // Allocate the Workers and their MemoryManagers and start their Threads
+    // (count = 0 => one Worker per online CPU).
+    // Returns -1 if no Memory could be allocated.
+    int init_workers (long count) {
+        num_workers = count;
+        if (num_workers <= 0) num_workers = sysconf(_SC_NPROCESSORS_ONLN);
+        if (num_workers <= 0) num_workers = 1;
+
+        workers = calloc(num_workers, sizeof(struct Worker));
+        if (workers == NULL) return -1;
+
+        for (long iLauf = 0; iLauf < num_workers; iLauf ++) {
+            if (
+                (init_chunks(&workers[iLauf].cells) < 0) ||
+                (init_chunks(&workers[iLauf].temp) < 0) ||
+                (init_chunks(&workers[iLauf].next) < 0)
+            ) {
+                // free_worker_chunks only frees the Chunks which were allocated
+                for (; iLauf >= 0; iLauf --) free_worker_chunks(&workers[iLauf]);
+                free(workers);
+                workers = NULL;
+                num_workers = 0;
+                return -1;
+            }
+        }
+
+        // Worker 0 is the Main Thread, so only start the other ones
+        workers_stop = false;
+        pthread_mutex_init(&worker_setup, NULL);
+        pthread_mutex_lock(&worker_setup);
+        for (long iLauf = 1; iLauf < num_workers; iLauf ++) {
+            if (pthread_create(&workers[iLauf].thread, NULL, worker_thread, &workers[iLauf]) != 0) {
+                // Continue with the Workers which could be started
+                for (long iLauf2 = iLauf; iLauf2 < num_workers; iLauf2 ++) {
+                    free_worker_chunks(&workers[iLauf2]);
+                }
+                num_workers = iLauf;
+                break;
+            }
+        }
+        pthread_barrier_init(&worker_start, NULL, num_workers);
+        pthread_barrier_init(&worker_done, NULL, num_workers);
+        pthread_mutex_unlock(&worker_setup);
+
+        return 0;
+    }
+
+    // Stop the Workers and free them and all of their Chunks
+    void uninit_workers () {
+        // Wake up the Workers one last Time, so they can exit.
+        workers_stop = true;
+        pthread_barrier_wait(&worker_start);
+        for (long iLauf = 1; iLauf < num_workers; iLauf ++) {
+            pthread_join(workers[iLauf].thread, NULL);
+        }
+        pthread_barrier_destroy(&worker_start);
+        pthread_barrier_destroy(&worker_done);
+        pthread_mutex_destroy(&worker_setup);
+
+        for (long iLauf = 0; iLauf < num_workers; iLauf ++) {
+            free_worker_chunks(&workers[iLauf]);
+        }
+        free(workers);
+        free(stripe_rows);
+        workers = NULL;
+        num_workers = 0;
+        stripe_rows = NULL;
+        stripe_rows_capacity = 0;
+    }
+
+    static void free_worker_chunks (struct Worker * w) {
+        if (w->cells.chunks != NULL) deallocate_chunks(&w->cells);
+        if (w->temp.chunks != NULL) deallocate_chunks(&w->temp);
+        if (w->next.chunks != NULL) deallocate_chunks(&w->next);
+    }
+
+// -------------------------------------------------------------------------- //
+
+    // Calculate the next Generation of alive_cells into next_cells using all
+    // Workers.
+    // Returns -1 if no more Memory could be allocated.
+    int parallel_round () {
+
+        int result = 0;
+        long count = 0;
+
+        if (alive_cells->num_elem == 0) return 0;
+
+        // Sort the Rows of all alive Cells
+        if (alive_cells->num_elem > stripe_rows_capacity) {
+            long * rows = realloc(stripe_rows, sizeof(long) * alive_cells->num_elem);
+            if (rows == NULL) return -1;
+            stripe_rows = rows;
+            stripe_rows_capacity = alive_cells->num_elem;
+        }
+        struct MemoryIterator iter = Iter.iter(alive_cells);
+        struct MemorySpan span = Iter.next_span(&iter);
+        while (span.len > 0) {
+            for (long iLauf = 0; iLauf < span.len; iLauf ++) {
+                stripe_rows[count ++] = span.elems[iLauf].y;
+            }
+            span = Iter.next_span(&iter);
+        }
+        qsort(stripe_rows, count, sizeof(long), compare_rows);
+
+        // Cut the Rows at the Quantiles of the Cells, so every Stripe gets
+        // the same Number of Cells no Matter how far they are spread out
+        // (e.g. by a Glider flying away). The first and last Stripe also
+        // get the Rows above and below the Cells, where Cells can be born.
+        for (long iLauf = 0; iLauf < num_workers; iLauf ++) {
+            workers[iLauf].y_begin = (iLauf == 0)
+                ? (stripe_rows[0] - 1)
+                : stripe_rows[count * iLauf / num_workers];
+            workers[iLauf].y_end = (iLauf == (num_workers - 1))
+                ? (stripe_rows[count - 1] + 2)
+                : stripe_rows[count * (iLauf + 1) / num_workers];
+        }
+
+        // Wake up the Workers and calculate the first Stripe on this Thread
+        pthread_barrier_wait(&worker_start);
+        run_worker(&workers[0]);
+        pthread_barrier_wait(&worker_done);
+
+        // Merge the Results of the Workers into the next Generation
+        for (long iLauf = 0; iLauf < num_workers; iLauf ++) {
+            if (
+                (workers[iLauf].result < 0) ||
+                (append_elems(next_cells, &workers[iLauf].next) < 0)
+            ) {
+                result = -1;
+            }
+            reset(&workers[iLauf].next);
+        }
+
+        return result;
+
+    }
+
+    static int compare_rows (const void * a, const void * b) {
+        const long self = *(const long *) a;
+        const long other = *(const long *) b;
+        return (self > other) - (self < other);
+    }
+
+// -------------------------------------------------------------------------- //
+
+    // Thread Function of the Workers 1 - num_workers-1
+    void * worker_thread (void * arg) {
+        struct Worker * w = arg;
+
+        // Wait until all Workers are started
+        pthread_mutex_lock(&worker_setup);
+        pthread_mutex_unlock(&worker_setup);
+
+        while (true) {
+            pthread_barrier_wait(&worker_start);
+            if (workers_stop) break;
+            run_worker(w);
+            pthread_barrier_wait(&worker_done);
+        }
+
+        return NULL;
+    }
+
+    // Calculate the Stripe of a Worker
+    void run_worker (struct Worker * w) {
+        // Many Cells in the same Row can leave a Stripe empty
+        if (w->y_begin >= w->y_end) {
+            w->result = 0;
+            reset_stats(&w->stats);
+            return;
+        }
+
+        w->result = collect_stripe(w);
+        if (w->result == 0) w->result = count_neighbours(&w->cells, &w->temp);
+        if (w->result == 0) w->result = decide_stripe(w);
+
+        reset(&w->cells);
+        reset(&w->temp);
+    }
+
+    // Copy all alive Cells of the Workers Stripe including the Border Rows
+    int collect_stripe (struct Worker * w) {
+        struct MemoryIterator iter = Iter.iter(alive_cells);
+        struct Cell * c = Iter.next(&iter);
+        while (c != NULL) {
+            if ((c->y >= (w->y_begin - 1)) && (c->y <= w->y_end)) {
+                if (stage_cell(&w->staged, &w->cells, *c) < 0) return -1;
+            }
+            c = Iter.next(&iter);
+        }
+        return flush_staged_cells(&w->staged, &w->cells);
+    }
+
+    // Write the surviving and newborn Cells inside the Workers Stripe into
+    // its next-MemoryManager.
+    // The Cells of the Border Rows are only used for counting Neighbours,
+    // their Fate is decided by the Workers owning them.
+    int decide_stripe (struct Worker * w) {
+        struct MemoryIterator iter = Iter.iter(&w->cells);
+        struct Cell * c = Iter.next(&iter);
+        const bool count = stats_stream.file != NULL;
+        bool survives;
+        PROFILE_TIMER(survive);
+        PROFILE_TIMER(resurrect);
+
+        reset_stats(&w->stats);
+
+        PROFILE_START(survive);
+        while (c != NULL) {
+            if ((c->y >= w->y_begin) && (c->y < w->y_end)) {
+                survives = options.rule.next[1][count_set_bits(*c)];
+                if (count) count_cell(&w->stats, true, survives, c->x, c->y);
+                if (survives) {
+                    TRACE(REVIVE, "Surviving Cell: (%ld, %ld) %ld", c->y, c->x, count_set_bits(*c));
+                    if (stage_cell(&w->staged, &w->next, *c) < 0) return -1;
+                } else {
+                    TRACE(KILL, "Dying Cell: (%ld, %ld) %ld", c->y, c->x, count_set_bits(*c));
+                }
+            }
+            c = Iter.next(&iter);
+        }
+        PROFILE_STOP(survive);
+        PROFILE_FLUSH(survive);
+
+        PROFILE_START(resurrect);
+        iter = Iter.iter(&w->temp);
+        c = Iter.next(&iter);
+        while (c != NULL) {
+            if ((c->y >= w->y_begin) && (c->y < w->y_end)) {
+                if (options.rule.next[0][count_set_bits(*c)]) {
+                    TRACE(REVIVE, "Ressurecting Cell (%ld, %ld) %ld", c->y, c->x, count_set_bits(*c));
+                    if (count) count_cell(&w->stats, false, true, c->x, c->y);
+                    if (stage_cell(&w->staged, &w->next, *c) < 0) return -1;
+                }
+            }
+            c = Iter.next(&iter);
+        }
+        int result = flush_staged_cells(&w->staged, &w->next);
+        PROFILE_STOP(resurrect);
+        PROFILE_FLUSH(resurrect);
+
+        return result;
+    }
+
+// -------------------------------------------------------------------------- //
+
+    #if TO_STDOUT == TRUE
+        // Draw all Cells of a MemoryManager using one of the Helper Functions
+        void redraw_cells (struct MemoryManager * m, void (*draw)(u8, int, int)) {
+            struct MemoryIterator iter = Iter.iter(m);
+            struct Cell * c = Iter.next(&iter);
+            while (c != NULL) {
+                draw(0, c->y, c->x);
+                c = Iter.next(&iter);
+            }
+        }
+    #endif
+
+#endif
+
+// -------------------------------------------------------------------------- //
+
 void create_glider(long y, long x) {
-    add_elem(&alive_cells, alive(y, x + 2));
-    add_elem(&alive_cells, alive(y + 1, x));
-    add_elem(&alive_cells, alive(y + 1, x + 2));
-    add_elem(&alive_cells, alive(y + 2, x + 1));
-    add_elem(&alive_cells, alive(y + 2, x + 2));
+    add_elem(alive_cells, alive(y, x + 2));
+    add_elem(alive_cells, alive(y + 1, x));
+    add_elem(alive_cells, alive(y + 1, x + 2));
+    add_elem(alive_cells, alive(y + 2, x + 1));
+    add_elem(alive_cells, alive(y + 2, x + 2));
 }
 
 // -------------------------------------------------------------------------- //
@@ -860,47 +1790,92 @@ void create_gosper_gun (long y, long x) {
     UNUSED(x);
     UNUSED(y);
 
-    add_elem(&alive_cells, alive(y + 4, x + 0));
-    add_elem(&alive_cells, alive(y + 5, x + 0));
-    add_elem(&alive_cells, alive(y + 4, x + 1));
-    add_elem(&alive_cells, alive(y + 5, x + 1));
-
-    add_elem(&alive_cells, alive(y + 3, x + 11));
-    add_elem(&alive_cells, alive(y + 2, x + 12));
-    add_elem(&alive_cells, alive(y + 2, x + 13));
-    add_elem(&alive_cells, alive(y + 4, x + 10));
-    add_elem(&alive_cells, alive(y + 5, x + 10));
-    add_elem(&alive_cells, alive(y + 5, x + 14));
-    add_elem(&alive_cells, alive(y + 6, x + 10));
-    add_elem(&alive_cells, alive(y + 7, x + 11));
-    add_elem(&alive_cells, alive(y + 8, x + 12));
-    add_elem(&alive_cells, alive(y + 8, x + 13));
-
-    add_elem(&alive_cells, alive(y + 3, x + 15));
-    add_elem(&alive_cells, alive(y + 4, x + 16));
-    add_elem(&alive_cells, alive(y + 5, x + 16));
-    add_elem(&alive_cells, alive(y + 5, x + 17));
-    add_elem(&alive_cells, alive(y + 6, x + 16));
-    add_elem(&alive_cells, alive(y + 7, x + 15));
-
-    add_elem(&alive_cells, alive(y + 2, x + 20));
-    add_elem(&alive_cells, alive(y + 3, x + 20));
-    add_elem(&alive_cells, alive(y + 4, x + 20));
-    add_elem(&alive_cells, alive(y + 2, x + 21));
-    add_elem(&alive_cells, alive(y + 3, x + 21));
-    add_elem(&alive_cells, alive(y + 4, x + 21));
-    add_elem(&alive_cells, alive(y + 1, x + 22));
-    add_elem(&alive_cells, alive(y + 5, x + 22));
-
-    add_elem(&alive_cells, alive(y + 0, x + 24));
-    add_elem(&alive_cells, alive(y + 1, x + 24));
-    add_elem(&alive_cells, alive(y + 5, x + 24));
-    add_elem(&alive_cells, alive(y + 6, x + 24));
-
-    add_elem(&alive_cells, alive(y + 3, x + 34));
-    add_elem(&alive_cells, alive(y + 3, x + 35));
-    add_elem(&alive_cells, alive(y + 4, x + 34));
-    add_elem(&alive_cells, alive(y + 4, x + 35));
+    add_elem(alive_cells, alive(y + 4, x + 0));
+    add_elem(alive_cells, alive(y + 5, x + 0));
+    add_elem(alive_cells, alive(y + 4, x + 1));
+    add_elem(alive_cells, alive(y + 5, x + 1));
+
+    add_elem(alive_cells, alive(y + 3, x + 11));
+    add_elem(alive_cells, alive(y + 2, x + 12));
+    add_elem(alive_cells, alive(y + 2, x + 13));
+    add_elem(alive_cells, alive(y + 4, x + 10));
+    add_elem(alive_cells, alive(y + 5, x + 10));
+    add_elem(alive_cells, alive(y + 5, x + 14));
+    add_elem(alive_cells, alive(y + 6, x + 10));
+    add_elem(alive_cells, alive(y + 7, x + 11));
+    add_elem(alive_cells, alive(y + 8, x + 12));
+    add_elem(alive_cells, alive(y + 8, x + 13));
+
+    add_elem(alive_cells, alive(y + 3, x + 15));
+    add_elem(alive_cells, alive(y + 4, x + 16));
+    add_elem(alive_cells, alive(y + 5, x + 16));
+    add_elem(alive_cells, alive(y + 5, x + 17));
+    add_elem(alive_cells, alive(y + 6, x + 16));
+    add_elem(alive_cells, alive(y + 7, x + 15));
+
+    add_elem(alive_cells, alive(y + 2, x + 20));
+    add_elem(alive_cells, alive(y + 3, x + 20));
+    add_elem(alive_cells, alive(y + 4, x + 20));
+    add_elem(alive_cells, alive(y + 2, x + 21));
+    add_elem(alive_cells, alive(y + 3, x + 21));
+    add_elem(alive_cells, alive(y + 4, x + 21));
+    add_elem(alive_cells, alive(y + 1, x + 22));
+    add_elem(alive_cells, alive(y + 5, x + 22));
+
+    add_elem(alive_cells, alive(y + 0, x + 24));
+    add_elem(alive_cells, alive(y + 1, x + 24));
+    add_elem(alive_cells, alive(y + 5, x + 24));
+    add_elem(alive_cells, alive(y + 6, x + 24));
+
+    add_elem(alive_cells, alive(y + 3, x + 34));
+    add_elem(alive_cells, alive(y + 3, x + 35));
+    add_elem(alive_cells, alive(y + 4, x + 34));
+    add_elem(alive_cells, alive(y + 4, x + 35));
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Write the alive Cells of the current Generation to the Dump.
+// Returns -1 if no Memory could be allocated or the File could not be written.
+int dump_sparse (long generation) {
+
+    struct MemoryIterator iter = Iter.iter(alive_cells);
+    struct MemorySpan span = Iter.next_span(&iter);
+    while (span.len > 0) {
+        for (long iLauf = 0; iLauf < span.len; iLauf ++) {
+            if (add_sparse_cell(&sparse_stream, span.elems[iLauf].y, span.elems[iLauf].x) < 0) return -1;
+        }
+        span = Iter.next_span(&iter);
+    }
+
+    return write_sparse(&sparse_stream, generation);
+
+}
+
+// Write the alive Cells inside the Board into the GIF (--gif), the ones
+// outside of it are left out.
+// Returns -1 if the GIF could not be written.
+int record_cells () {
+
+    if (gif.file == NULL) return 0;
+
+    memset(gif.bits, 0, sizeof(uint64_t) * gif.words * gif.height);
+
+    struct MemoryIterator iter = Iter.iter(alive_cells);
+    struct MemorySpan span = Iter.next_span(&iter);
+    while (span.len > 0) {
+        for (long iLauf = 0; iLauf < span.len; iLauf ++) {
+            const long x = span.elems[iLauf].x;
+            const long y = span.elems[iLauf].y;
+            if ((x >= 0) && (x < gif.width) && (y >= 0) && (y < gif.height)) {
+                gif.bits[y * gif.words + x / 64] |= 1ULL << (x % 64);
+            }
+        }
+        span = Iter.next_span(&iter);
+    }
+
+    return write_gif_frame(&gif, gif.bits, gif.words);
 
 }
 
@@ -16,7 +16,9 @@
 #define GOSPER_GUN FALSE
 
 // Prints Output to .pbm Files
-#define TO_FILE FALSE
+#ifndef TO_FILE
+    #define TO_FILE FALSE
+#endif
 // Run in Debug-Mode => Displays Neighbour-Count
 // This Option only has an Effect if TO_FILE is false
 #define DEBUG TRUE
@@ -36,8 +38,16 @@
     #define FILE_FORMATTER "gol_%05d.pbm"
 #endif
 
-// Delay between rounds when the Game is displayed on the Terminal.
-#define DELAY 0.5
+// Delay between rounds (in ms) when the Game is displayed on the Terminal.
+// Can be changed using --delay-ms or --fps.
+#ifndef DELAY_MS
+    #define DELAY_MS 500
+#endif
+
+// Number of Threads calculating a Generation (0 = one per online CPU)
+#ifndef THREADS
+    #define THREADS 0
+#endif
 
 // Because of all the Options sometimes the Compiler would complain
 // about unused Parameters which would be needed for other Options.
@@ -46,26 +56,72 @@
 
 // -------------------------------------------------------------------------- //
 
+#include "options.c"
+#include "profile.c"
+#include "scheduler.c"
+#include "stats.c"
+
+// Arguments for the Tile Functions, which are called by the Scheduler
+struct StepContext {
+    struct Cell ** cells;
+    int width;
+    int height;
+};
+
+struct Scheduler scheduler;
+
+// Statistics of every Generation (only used with --stats)
+struct StatsStream stats_stream;
+
+// Frames shown on the Terminal (only used if TO_FILE is FALSE)
+struct Renderer renderer;
+// Draws the Frames with --render-thread
+struct RenderThread render_thread;
+
+// Animated GIF of the Generations (only used with --gif)
+struct GifWriter gif;
+// Compressed Stream of the Generations (only used with --frames)
+struct FrameStream frame_stream;
+
+// -------------------------------------------------------------------------- //
+
 struct Cell ** init (int width, int height, double density);
-void main_loop (struct Cell ** cells, int width, int height, int steps);
-void print_cells(struct Cell ** cells, int width, int height);
+int main_loop (struct Cell ** cells, int width, int height, int steps);
+int print_cells(struct Cell ** cells, int width, int height, int round, bool last);
 void create_gosper_gun(struct Cell ** cells, int x, int y, int width, int height);
 void uninit(struct Cell ** cells, int height);
 void print_cells_to_file(struct Cell ** cells, int iStep, int width, int height);
-
-// -------------------------------------------------------------------------- //
-
-void printUsage(const char* programName) {
-    printf("usage: %s <width> <height> <density> <steps>\n", programName);
-}
+void pack_cells (struct Cell ** cells, int width, int height, uint64_t * bits);
+int record_cells (struct Cell ** cells, int width, int height, int generation);
+void count_tile (void * ctx, struct Tile tile);
+void update_tile (void * ctx, struct Tile tile);
+void exchange_halo (struct Cell ** cells, int width, int height);
 
 // -------------------------------------------------------------------------- //
 
 int game_of_life(int argc, char* argv[]) {
-    if(argc != 5) {
+    if(argc < 5) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (parse_options(argc, argv, &options) < 0) {
         printUsage(argv[0]);
         return EXIT_FAILURE;
     }
+    // The Board has Bounds, so all its Cells fit into --frames
+    if (options.sparse_path != NULL) {
+        printf("--sparse is only supported by the Complicated Variant\n");
+        return EXIT_FAILURE;
+    }
+    // The other Variants keep the State of their Board in Globals
+    if ((options.batch_path != NULL) || (options.census_path != NULL)) {
+        printf("--batch and --census are only supported by the Packed Variant\n");
+        return EXIT_FAILURE;
+    }
+    if (start_trace(options.trace, options.trace_path) < 0) {
+        printf("Could not start the Trace\n");
+        return EXIT_FAILURE;
+    }
 
     const int width = atoi(argv[1]);
     const int height = atoi(argv[2]);
@@ -83,24 +139,125 @@ int game_of_life(int argc, char* argv[]) {
     // Allocate a 2d-Array using Malloc
     struct Cell ** cells = init(width, height, density);
 
+    // Start the Threads calculating the Generations
+    if (init_scheduler(&scheduler, THREADS, width, height) < 0) {
+        printf("\x1B[?1049l\x1B[?25h");
+        printf("Could not start the Scheduler\n");
+        uninit(cells, height);
+        stop_trace();
+        return EXIT_FAILURE;
+    }
+
+    if (
+        (options.stats_path != NULL) &&
+        (open_stats(&stats_stream, options.stats_path, scheduler.num_threads) < 0)
+    ) {
+        printf("\x1B[?1049l\x1B[?25h");
+        printf("Could not open the Statistics File \"%s\"\n", options.stats_path);
+        uninit_scheduler(&scheduler);
+        uninit(cells, height);
+        stop_trace();
+        return EXIT_FAILURE;
+    }
+
+    if (
+        (options.gif_path != NULL) &&
+        (open_gif(&gif, options.gif_path, width, height, options.gif_scale, options.gif_delay) < 0)
+    ) {
+        printf("\x1B[?1049l\x1B[?25h");
+        printf("Could not create the GIF \"%s\"\n", options.gif_path);
+        close_stats(&stats_stream);
+        uninit_scheduler(&scheduler);
+        uninit(cells, height);
+        stop_trace();
+        return EXIT_FAILURE;
+    }
+
+    if (
+        (options.frames_path != NULL) &&
+        (open_frame_stream(&frame_stream, options.frames_path, width, height) < 0)
+    ) {
+        printf("\x1B[?1049l\x1B[?25h");
+        printf("Could not create the Frame Stream \"%s\"\n", options.frames_path);
+        close_gif(&gif);
+        close_stats(&stats_stream);
+        uninit_scheduler(&scheduler);
+        uninit(cells, height);
+        stop_trace();
+        return EXIT_FAILURE;
+    }
+
+    #if TO_FILE == FALSE
+        if (init_renderer(&renderer, options.view, width, height, options.render_fps) < 0) {
+            printf("\x1B[?1049l\x1B[?25h");
+            printf("Could not allocate the Frames for the Terminal\n");
+            close_frame_stream(&frame_stream);
+            close_gif(&gif);
+            close_stats(&stats_stream);
+            uninit_scheduler(&scheduler);
+            uninit(cells, height);
+            stop_trace();
+            return EXIT_FAILURE;
+        }
+        if (options.render_thread && (start_render_thread(&render_thread, &renderer) < 0)) {
+            printf("\x1B[?1049l\x1B[?25h");
+            printf("Could not start the Render Thread\n");
+            uninit_renderer(&renderer);
+            close_frame_stream(&frame_stream);
+            close_gif(&gif);
+            close_stats(&stats_stream);
+            uninit_scheduler(&scheduler);
+            uninit(cells, height);
+            stop_trace();
+            return EXIT_FAILURE;
+        }
+    #endif
+
     // Loop for the Amount specified in Steps
-    main_loop(cells, width, height, steps);
+    int result = main_loop(cells, width, height, steps);
+
+    #if TO_FILE == FALSE
+        // Draw the last Snapshot before the Terminal is restored
+        if (options.render_thread && (stop_render_thread(&render_thread) < 0)) {
+            fprintf(stderr, "Could not write to the Terminal\n");
+            result = -1;
+        }
+    #endif
 
     // Restore Terminal Output and show the cursor again
     printf("\x1B[?1049l\x1B[?25h");
 
+    if (close_frame_stream(&frame_stream) < 0) {
+        printf("Could not write the Frame Stream \"%s\"\n", options.frames_path);
+        result = -1;
+    }
+    if (close_gif(&gif) < 0) {
+        printf("Could not write the GIF \"%s\"\n", options.gif_path);
+        result = -1;
+    }
+    close_stats(&stats_stream);
+    #if TO_FILE == FALSE
+        uninit_renderer(&renderer);
+    #endif
+
+    uninit_scheduler(&scheduler);
     uninit(cells, height);
+    stop_trace();
 
-    return EXIT_SUCCESS;
+    return (result < 0) ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 
 // -------------------------------------------------------------------------- //
 
 // Allocate Memory for the 2d-Array Game Field and initialize it
+// The Field gets a Ring of Ghost Cells around it, so cells[-1][-1] up to
+// cells[height][width] are valid. This way the Neighbours of the Cells on the
+// Edges can be read without checking the Field Boundaries.
 struct Cell ** init (int width, int height, double density) {
 
     // Allocate Array of Pointers to the Arrays containing the Cells
-    struct Cell ** cells = malloc (sizeof(struct Cell *) * height);
+    // (including the Ghost Rows above and below the Field)
+    struct Cell ** cells = malloc (sizeof(struct Cell *) * (height + 2));
 
     // Check that Malloc worked
     if (!cells) {
@@ -118,8 +275,8 @@ struct Cell ** init (int width, int height, double density) {
     #endif
 
     // Allocate/Initialize the Arrays of Cells
-    for (long iLauf = 0; iLauf < height; iLauf ++) {
-        cells[iLauf] = malloc(sizeof(struct Cell) * width);
+    for (long iLauf = 0; iLauf < (height + 2); iLauf ++) {
+        cells[iLauf] = malloc(sizeof(struct Cell) * (width + 2));
         // Check that Malloc worked
         if (!cells[iLauf]) {
             printf("Malloc failed\n");
@@ -128,20 +285,26 @@ struct Cell ** init (int width, int height, double density) {
             free(cells);
             exit(1);
         }
-        // Initialize Cells
-        for (int iLauf2 = 0; iLauf2 < width; iLauf2 ++) {
+        // Initialize Cells (the Ghost Cells always start out dead)
+        for (int iLauf2 = 0; iLauf2 < (width + 2); iLauf2 ++) {
+            cells[iLauf][iLauf2] = dead();
             #if RANDOM == TRUE
-                if (rand() <= i_density) {
+                if (
+                    (iLauf > 0) && (iLauf <= height) &&
+                    (iLauf2 > 0) && (iLauf2 <= width) &&
+                    (rand() <= i_density)
+                ) {
                     cells[iLauf][iLauf2] = alive();
-                } else {
-                    cells[iLauf][iLauf2] = dead();
                 }
-            #else
-                cells[iLauf][iLauf2] = dead();
             #endif
         }
+        // Let the Row start at the first Cell of the Field, so the left
+        // Ghost Cell has the Index -1.
+        cells[iLauf] += 1;
     }
 
+    // Same for the Rows, so the upper Ghost Row has the Index -1.
+    cells += 1;
 
 #if GOSPER_GUN == TRUE
     // Use the density-Parameter in some kind, otherwise the Compiler will
@@ -157,10 +320,34 @@ struct Cell ** init (int width, int height, double density) {
 // Free the Memory allocated by the Init Function
 // NOTE: I could not find a better name for this funtion
 void uninit(struct Cell ** cells, int height) {
-    for (long iLauf = 0; iLauf < height; iLauf ++) {
-        free(cells[iLauf]);
+    for (long iLauf = -1; iLauf <= height; iLauf ++) {
+        free(cells[iLauf] - 1);
     }
-    free(cells);
+    free(cells - 1);
+}
+
+// -------------------------------------------------------------------------- //
+
+// Fill the Ghost Cells around the Field before a Generation is calculated.
+// With Dead Edges nothing has to be done, because the Ghost Cells are never
+// written and stay dead. On a Torus each Ghost Cell gets a Copy of the
+// Cell on the opposite Edge of the Field.
+void exchange_halo (struct Cell ** cells, int width, int height) {
+    #if TOPOLOGY == TORUS
+        // Left and right Ghost Column
+        for (long iLauf = 0; iLauf < height; iLauf ++) {
+            cells[iLauf][-1] = cells[iLauf][width-1];
+            cells[iLauf][width] = cells[iLauf][0];
+        }
+        // Upper and lower Ghost Row (including the Corners, which were
+        // already wrapped horizontally)
+        memcpy(cells[-1] - 1, cells[height-1] - 1, sizeof(struct Cell) * (width + 2));
+        memcpy(cells[height] - 1, cells[0] - 1, sizeof(struct Cell) * (width + 2));
+    #else
+        UNUSED(cells);
+        UNUSED(width);
+        UNUSED(height);
+    #endif
 }
 
 // -------------------------------------------------------------------------- //
@@ -171,104 +358,219 @@ void uninit(struct Cell ** cells, int height) {
 //      3. Revive dead cells with 3 alive neighbours, kill cells
 //         that do not have 2 or 3 neighbours and reset each Cells
 //         Neighbour Count.
-//      4. Short Delay
-void main_loop (struct Cell ** cells, int width, int height, int steps) {
+//      4. Write the Statistics of the new Generation (with --stats)
+//      5. Wait for the next Generation (--fps, --delay-ms)
+// Returns -1 if the Board or the Statistics could not be written.
+int main_loop (struct Cell ** cells, int width, int height, int steps) {
+
+    struct StepContext ctx = {
+        .cells = cells,
+        .width = width,
+        .height = height
+    };
+    PROFILE_TIMER(output);
+    PROFILE_TIMER(compute);
+
+    // Pace the Generations (only if they are shown on the Terminal, unless
+    // a Rate was given)
+    struct Pacer pacer;
+    #if TO_FILE == TRUE
+        init_pacer(&pacer, pace_interval(&options, 0));
+    #else
+        init_pacer(&pacer, pace_interval(&options, DELAY_MS));
+    #endif
 
     for (int iStep = 0; iStep < steps; iStep ++) {
         // Display the Board (either in a File or on the Terminal)
+        PROFILE_START(output);
         #if TO_FILE == TRUE
-            print_cells_to_file(cells, iStep, width, height);
+            // With --gif or --frames the Generations only go there
+            if ((gif.file == NULL) && (frame_stream.file == NULL)) {
+                print_cells_to_file(cells, iStep, width, height);
+            }
         #else
-            // Some Terminal ANSI-Commands to clear the Screen every Re-Render
-            printf("\x1B[25l\x1B[3J\x1B[0;0H\x1B[34mRound %d:\n\n", iStep + 1);
-            print_cells(cells, width, height);
+            if (print_cells(cells, width, height, iStep + 1, iStep == (steps - 1)) < 0) return -1;
         #endif
-        // Calculate neighbours
-        for (int iLauf = 0; iLauf < height; iLauf++) {
-            for (int iLauf2 = 0; iLauf2 < width; iLauf2++) {
-                // Reset Neighbour Count
-                cells[iLauf][iLauf2].neighbours = 0;
-                // Count all alive Neighbour Cells
-                // I don't know how to write this more concise, because I have
-                // to test for Field Boundaries
-                if ((iLauf - 1) >= 0) {
-                    cells[iLauf][iLauf2].neighbours += cells[iLauf-1][iLauf2].alive;
-                    if ((iLauf2 - 1) >= 0)
-                        cells[iLauf][iLauf2].neighbours += cells[iLauf-1][iLauf2-1].alive;
-                    if ((iLauf2 + 1) < width)
-                        cells[iLauf][iLauf2].neighbours += cells[iLauf-1][iLauf2+1].alive;
-                }
-                if ((iLauf2 - 1) >= 0)
-                    cells[iLauf][iLauf2].neighbours += cells[iLauf][iLauf2-1].alive;
-                if ((iLauf2 + 1) < width) {
-                    cells[iLauf][iLauf2].neighbours += cells[iLauf][iLauf2+1].alive;
-                }
-                if ((iLauf + 1) < height) {
-                    cells[iLauf][iLauf2].neighbours += cells[iLauf+1][iLauf2].alive;
-                    if ((iLauf2 - 1) >= 0)
-                        cells[iLauf][iLauf2].neighbours += cells[iLauf+1][iLauf2-1].alive;
-                    if ((iLauf2 + 1) < width)
-                        cells[iLauf][iLauf2].neighbours += cells[iLauf+1][iLauf2+1].alive;
-                }
-
-            }
+        if (record_cells(cells, width, height, iStep) < 0) {
+            printf("Could not write the GIF or the Frame Stream\n");
+            return -1;
         }
+        PROFILE_STOP(output);
+        PROFILE_START(compute);
+        // Calculate neighbours of all Cells before any of them are changed
+        exchange_halo(cells, width, height);
+        run_tiles(&scheduler, count_tile, &ctx);
         // Revive previously Cells, remove dead Cells and reset neighbour-Count
-        for (int iLauf = 0; iLauf < height; iLauf++) {
-            for (int iLauf2 = 0; iLauf2 < width; iLauf2++) {
-                // A Cell is alive if it is already alive and has 2 alive
-                // neighbours or if it has 3 alive neighbours (ignoring
-                // if it is alive or dead)
-                if (
-                    (
-                        (cells[iLauf][iLauf2].alive) &&
-                        (cells[iLauf][iLauf2].neighbours == 2)
-                    ) ||
-                    (cells[iLauf][iLauf2].neighbours == 3)
-                ) {
-                    cells[iLauf][iLauf2].alive = true;
-                } else {
-                    cells[iLauf][iLauf2].alive = false;
-                }
-            }
+        run_tiles(&scheduler, update_tile, &ctx);
+        PROFILE_STOP(compute);
+        PROFILE_START(output);
+        if ((stats_stream.file != NULL) && (write_stats(&stats_stream, iStep + 1) < 0)) {
+            printf("Could not write the Statistics\n");
+            return -1;
         }
+        PROFILE_STOP(output);
+        PROFILE_FLUSH(output);
+        PROFILE_FLUSH(compute);
+        PROFILE_GENERATION();
         #if DEBUG == TRUE
-            getchar();
+            // Wait for Enter, unless a Rate was given or the Frames are drawn
+            // by the Render Thread
+            if ((options.delay < 0) && !options.render_thread) {
+                getchar();
+            } else {
+                pace(&pacer);
+            }
         #else
-            sleep(DELAY);
+            pace(&pacer);
         #endif
     }
 
+    return 0;
+
 }
 
 // -------------------------------------------------------------------------- //
 
-// Print the Cell Array to STDOUT using colors
-void print_cells(struct Cell ** cells, int width, int height) {
+// Calculate the Sum of alive Neighbours for all Cells inside the Tile
+// Thanks to the Ghost Cells every Cell has 8 Neighbours which can be read
+// without checking the Field Boundaries.
+void count_tile (void * arg, struct Tile tile) {
+
+    struct StepContext * ctx = arg;
+    struct Cell ** cells = ctx->cells;
+
+    for (int iLauf = tile.y_begin; iLauf < tile.y_end; iLauf++) {
+        const struct Cell * above = cells[iLauf-1];
+        const struct Cell * below = cells[iLauf+1];
+        struct Cell * row = cells[iLauf];
+        for (int iLauf2 = tile.x_begin; iLauf2 < tile.x_end; iLauf2++) {
+            // Count all alive Neighbour Cells
+            row[iLauf2].neighbours =
+                above[iLauf2-1].alive + above[iLauf2].alive + above[iLauf2+1].alive +
+                row[iLauf2-1].alive                         + row[iLauf2+1].alive +
+                below[iLauf2-1].alive + below[iLauf2].alive + below[iLauf2+1].alive;
+        }
+    }
+
+}
+
+// Revive or kill all Cells inside the Tile depending on their Neighbours
+// (and count the Statistics of the Tile with --stats)
+void update_tile (void * arg, struct Tile tile) {
+
+    struct StepContext * ctx = arg;
+    struct Cell ** cells = ctx->cells;
+    const bool (* next)[9] = options.rule.next;
+    const bool count = stats_stream.file != NULL;
+    struct Stats tile_stats;
+    reset_stats(&tile_stats);
+
+    for (int iLauf = tile.y_begin; iLauf < tile.y_end; iLauf++) {
+        struct Cell * row = cells[iLauf];
+        for (int iLauf2 = tile.x_begin; iLauf2 < tile.x_end; iLauf2++) {
+            // Look up if the Cell is alive in the next Generation depending
+            // on its State and its Neighbours
+            bool alive = next[row[iLauf2].alive][row[iLauf2].neighbours];
+            if (count) count_cell(&tile_stats, row[iLauf2].alive, alive, iLauf2, iLauf);
+            row[iLauf2].alive = alive;
+        }
+    }
+
+    if (count) add_tile_stats(&stats_stream.slots[scheduler_thread_index()], &tile_stats);
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Show the Cell Array on the Terminal using colors.
+// Only the Cells which changed since the last Round are redrawn.
+// With --render-thread the Board is only handed to the Render Thread (if it
+// wants a new Frame, or for the last Round).
+// Returns -1 if the Terminal could not be written to.
+int print_cells(struct Cell ** cells, int width, int height, int round, bool last) {
+
+    uint64_t * bits = renderer.bits;
+
+    if (options.render_thread) {
+        bits = render_snapshot(&render_thread, last);
+        if (bits == NULL) return 0;
+    } else if (!render_due(&renderer)) {
+        // Skip the Frame if its Time has not come yet (--render-fps)
+        return 0;
+    }
+
+    if (options.render_thread || (renderer.mode != RENDER_CELLS)) {
+        // The Snapshots and the scaled down Views are made from a packed Board
+        pack_cells(cells, width, height, bits);
+        if (options.render_thread) {
+            publish_snapshot(&render_thread, round);
+            return 0;
+        }
+        render_rows(&renderer, bits, renderer.words);
+        return render_frame(&renderer, round);
+    }
+
+    unsigned char * frame = renderer.current;
 
     for (long iLauf = 0; iLauf < height; iLauf ++) {
         for (long iLauf2 = 0; iLauf2 < width; iLauf2 ++) {
             #if DEBUG == FALSE
-                // Print a green 'a' when the Cell is alive
-                // Print a red 'd' when the Cell is dead
-                printf(
-                    "\x1B[%dm %c",
-                    cells[iLauf][iLauf2].alive ? 32 : 31,
+                // Show a green 'a' when the Cell is alive
+                // Show a red 'd' when the Cell is dead
+                *frame++ = render_cell(
+                    cells[iLauf][iLauf2].alive,
                     cells[iLauf][iLauf2].alive ? 'a' : 'd'
                 );
             #else
-                // Print the number of neighbours of the Cell in the last
+                // Show the number of neighbours of the Cell in the last
                 // Generation in green or red depending on whether it
                 // is alive in this Generation.
-                printf(
-                    "\x1B[%dm %d",
-                    cells[iLauf][iLauf2].alive ? 32 : 31,
-                    cells[iLauf][iLauf2].neighbours
+                *frame++ = render_cell(
+                    cells[iLauf][iLauf2].alive,
+                    '0' + cells[iLauf][iLauf2].neighbours
                 );
             #endif
         }
-        printf("\n");
     }
+
+    return render_frame(&renderer, round);
+}
+
+// -------------------------------------------------------------------------- //
+
+// Pack the Cells into Bits (Bit x of Row y is Bit x % 64 of Word x / 64,
+// with (width + 63) / 64 Words per Row), which is what the Views of the
+// Terminal and the GIF are made from.
+void pack_cells (struct Cell ** cells, int width, int height, uint64_t * bits) {
+    const long words = (width + 63) / 64;
+    for (long iLauf = 0; iLauf < height; iLauf ++) {
+        uint64_t * row = bits + iLauf * words;
+        memset(row, 0, sizeof(uint64_t) * words);
+        for (long iLauf2 = 0; iLauf2 < width; iLauf2 ++) {
+            row[iLauf2 / 64] |= (uint64_t) cells[iLauf][iLauf2].alive << (iLauf2 % 64);
+        }
+    }
+}
+
+
+// Write the Generation into the GIF (--gif) and the Frame Stream (--frames),
+// which both take the packed Board.
+// Returns -1 if one of them could not be written.
+int record_cells (struct Cell ** cells, int width, int height, int generation) {
+
+    if ((gif.file == NULL) && (frame_stream.file == NULL)) return 0;
+
+    uint64_t * bits = (gif.file != NULL) ? gif.bits : frame_stream.bits;
+    const long words = (width + 63) / 64;
+    pack_cells(cells, width, height, bits);
+
+    if ((gif.file != NULL) && (write_gif_frame(&gif, bits, words) < 0)) return -1;
+    if ((frame_stream.file != NULL) && (write_frame(&frame_stream, bits, words, generation) < 0)) {
+        return -1;
+    }
+
+    return 0;
+
 }
 
 // -------------------------------------------------------------------------- //
@@ -0,0 +1,418 @@
+
+// -------------------------------------------------------------------------- //
+// --- Explanation ---------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Compressed Stream of the Generations, which is written while the Game runs
+// and can be read back Frame by Frame:
+//
+//      ./game 500 400 0.3 1000 --frames run.golf
+//
+// Every Frame is compressed on its own (no Frame refers to another one), so
+// any Frame can be decoded without the ones before it, and several Threads
+// can decode different Frames at the same Time. An Index at the End of the
+// File holds the Offset of every Frame.
+//
+// File Layout (all Numbers are Little Endian):
+//
+//      "GOLF" | u32 Version | u32 Width | u32 Height           => Header
+//      u32 Generation | u32 Size | Size Bytes of Data          => Frame 0
+//      ...                                                     => Frame n - 1
+//      u64 Offset of Frame 0 | ... | u64 Offset of Frame n - 1 => Index
+//      u64 n | u64 Offset of the Index | "GOLI"                => Footer
+//
+// The Data of a Frame is the packed Board (Bit x of Row y is Bit x % 64 of
+// Word x / 64, (width + 63) / 64 Words per Row), stored Byte by Byte, as a
+// Sequence of Runs:
+//
+//      Varint Zeros | Varint Literals | Literals Bytes | Varint Zeros | ...
+//
+// The Boards are mostly dead, so most of their Bytes are 0 and a whole dead
+// Area only takes 2 Bytes. Zero Runs shorter than 3 Bytes are stored as part
+// of the Literals, since a new Run would cost more than it saves.
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+#include <fcntl.h>
+
+#define FRAMES_VERSION 1
+#define FRAMES_HEADER 16
+#define FRAMES_FOOTER 20
+// Shortest Zero Run which ends a Run of Literals
+#define FRAMES_MIN_ZEROS 3
+
+struct FrameStream {
+    FILE * file;
+    int width;
+    int height;
+    // Words of a packed Row
+    long words;
+    // Packed Board for Variants which store the Cells differently
+    uint64_t * bits;
+    // One Frame as Bytes and compressed
+    unsigned char * raw;
+    unsigned char * data;
+    size_t raw_size;
+    // Offsets of the written Frames
+    uint64_t * offsets;
+    long frames;
+    long capacity;
+    uint64_t position;
+};
+
+struct FrameReader {
+    int fd;
+    int width;
+    int height;
+    long words;
+    long frames;
+    uint64_t * offsets;
+    // Offset of the Index (the End of the last Frame)
+    uint64_t end;
+};
+
+// -------------------------------------------------------------------------- //
+
+int open_frame_stream (struct FrameStream * s, const char * path, int width, int height);
+int close_frame_stream (struct FrameStream * s);
+int write_frame (struct FrameStream * s, const uint64_t * cells, long stride, long generation);
+int open_frame_reader (struct FrameReader * r, const char * path);
+void close_frame_reader (struct FrameReader * r);
+int read_frame (const struct FrameReader * r, long index, uint64_t * cells, long * generation);
+size_t encode_frame (const unsigned char * raw, size_t size, unsigned char * data);
+int decode_frame (const unsigned char * data, size_t length, unsigned char * raw, size_t size);
+static void frames_put (unsigned char * buffer, uint64_t value, int bytes);
+static uint64_t frames_get (const unsigned char * buffer, int bytes);
+static size_t put_varint (unsigned char * data, uint64_t value);
+static int get_varint (const unsigned char * data, size_t length, size_t * pos, uint64_t * value);
+
+// -------------------------------------------------------------------------- //
+
+// Create the File and write its Header.
+// Returns -1 if no Memory could be allocated or the File could not be opened.
+int open_frame_stream (struct FrameStream * s, const char * path, int width, int height) {
+
+    if ((width <= 0) || (height <= 0)) return -1;
+
+    s->width = width;
+    s->height = height;
+    s->words = (width + 63) / 64;
+    s->raw_size = (size_t) s->words * 8 * height;
+    s->frames = 0;
+    s->capacity = 64;
+    s->position = FRAMES_HEADER;
+
+    s->bits = calloc((size_t) s->words * height, sizeof(uint64_t));
+    s->raw = malloc(s->raw_size);
+    // Worst Case: A Run of 1 Literal after every 3 Zeros (3 Bytes per 4)
+    s->data = malloc(s->raw_size + 32);
+    s->offsets = malloc(sizeof(uint64_t) * s->capacity);
+    s->file = NULL;
+    if ((s->bits == NULL) || (s->raw == NULL) || (s->data == NULL) || (s->offsets == NULL)) {
+        close_frame_stream(s);
+        return -1;
+    }
+
+    s->file = fopen(path, "wb");
+    if (s->file == NULL) {
+        close_frame_stream(s);
+        return -1;
+    }
+
+    unsigned char header[FRAMES_HEADER] = "GOLF";
+    frames_put(header + 4, FRAMES_VERSION, 4);
+    frames_put(header + 8, width, 4);
+    frames_put(header + 12, height, 4);
+    fwrite(header, 1, FRAMES_HEADER, s->file);
+
+    return ferror(s->file) ? -1 : 0;
+
+}
+
+// Write the Index, close the File and free the Buffers.
+// Does nothing if the Stream was never opened.
+// Returns -1 if the File could not be written.
+int close_frame_stream (struct FrameStream * s) {
+
+    int result = 0;
+
+    if (s->file != NULL) {
+        unsigned char entry[8];
+        for (long iLauf = 0; iLauf < s->frames; iLauf ++) {
+            frames_put(entry, s->offsets[iLauf], 8);
+            fwrite(entry, 1, 8, s->file);
+        }
+        unsigned char footer[FRAMES_FOOTER];
+        frames_put(footer, s->frames, 8);
+        frames_put(footer + 8, s->position, 8);
+        memcpy(footer + 16, "GOLI", 4);
+        fwrite(footer, 1, FRAMES_FOOTER, s->file);
+
+        if (ferror(s->file)) result = -1;
+        if (fclose(s->file) != 0) result = -1;
+    }
+
+    free(s->bits);
+    free(s->raw);
+    free(s->data);
+    free(s->offsets);
+    s->file = NULL;
+    s->bits = NULL;
+    s->raw = NULL;
+    s->data = NULL;
+    s->offsets = NULL;
+
+    return result;
+
+}
+
+// Compress the Board (stride Words from one Row to the next) and append it
+// as the next Frame.
+// Returns -1 if the Index could not grow or the File could not be written.
+int write_frame (struct FrameStream * s, const uint64_t * cells, long stride, long generation) {
+
+    if (s->frames == s->capacity) {
+        uint64_t * offsets = realloc(s->offsets, sizeof(uint64_t) * s->capacity * 2);
+        if (offsets == NULL) return -1;
+        s->offsets = offsets;
+        s->capacity *= 2;
+    }
+
+    // Bits behind the last Cell of a Row are always stored as 0
+    const uint64_t last_mask = (s->width % 64) ? ((1ULL << (s->width % 64)) - 1) : ~0ULL;
+    unsigned char * raw = s->raw;
+    for (long iLauf = 0; iLauf < s->height; iLauf ++) {
+        const uint64_t * row = cells + iLauf * stride;
+        for (long iLauf2 = 0; iLauf2 < s->words; iLauf2 ++) {
+            uint64_t word = row[iLauf2];
+            if (iLauf2 == (s->words - 1)) word &= last_mask;
+            frames_put(raw, word, 8);
+            raw += 8;
+        }
+    }
+
+    const size_t length = encode_frame(s->raw, s->raw_size, s->data);
+    unsigned char header[8];
+    frames_put(header, generation, 4);
+    frames_put(header + 4, length, 4);
+    fwrite(header, 1, 8, s->file);
+    fwrite(s->data, 1, length, s->file);
+
+    s->offsets[s->frames ++] = s->position;
+    s->position += 8 + length;
+
+    return ferror(s->file) ? -1 : 0;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Open a Stream and read its Index.
+// Returns -1 if the File could not be read or is not a valid Stream.
+int open_frame_reader (struct FrameReader * r, const char * path) {
+
+    unsigned char header[FRAMES_HEADER], footer[FRAMES_FOOTER];
+
+    r->offsets = NULL;
+    r->fd = open(path, O_RDONLY);
+    if (r->fd < 0) return -1;
+
+    const off_t size = lseek(r->fd, 0, SEEK_END);
+    if (
+        (size < (FRAMES_HEADER + FRAMES_FOOTER)) ||
+        (pread(r->fd, header, FRAMES_HEADER, 0) != FRAMES_HEADER) ||
+        (pread(r->fd, footer, FRAMES_FOOTER, size - FRAMES_FOOTER) != FRAMES_FOOTER) ||
+        (memcmp(header, "GOLF", 4) != 0) || (memcmp(footer + 16, "GOLI", 4) != 0) ||
+        (frames_get(header + 4, 4) != FRAMES_VERSION)
+    ) {
+        close_frame_reader(r);
+        return -1;
+    }
+
+    r->width = frames_get(header + 8, 4);
+    r->height = frames_get(header + 12, 4);
+    r->words = (r->width + 63) / 64;
+    r->frames = frames_get(footer, 8);
+    r->end = frames_get(footer + 8, 8);
+
+    // The Index has to fit exactly between the Frames and the Footer
+    if (
+        (r->width <= 0) || (r->height <= 0) || (r->end < FRAMES_HEADER) ||
+        (r->frames < 0) || ((uint64_t) r->frames > ((uint64_t) size / 8)) ||
+        ((r->end + 8 * (uint64_t) r->frames + FRAMES_FOOTER) != (uint64_t) size)
+    ) {
+        close_frame_reader(r);
+        return -1;
+    }
+
+    unsigned char * index = malloc(8 * r->frames + 1);
+    r->offsets = malloc(sizeof(uint64_t) * r->frames + 1);
+    if (
+        (index == NULL) || (r->offsets == NULL) ||
+        (pread(r->fd, index, 8 * r->frames, r->end) != (ssize_t) (8 * r->frames))
+    ) {
+        free(index);
+        close_frame_reader(r);
+        return -1;
+    }
+    for (long iLauf = 0; iLauf < r->frames; iLauf ++) {
+        r->offsets[iLauf] = frames_get(index + 8 * iLauf, 8);
+    }
+    free(index);
+
+    return 0;
+
+}
+
+void close_frame_reader (struct FrameReader * r) {
+    if (r->fd >= 0) close(r->fd);
+    free(r->offsets);
+    r->fd = -1;
+    r->offsets = NULL;
+}
+
+// Decode Frame index into cells (words Words per Row) and get its Generation.
+// Only reads the File using pread, so several Threads can decode Frames of
+// the same Reader at once.
+// Returns -1 if the Frame could not be read or is corrupt.
+int read_frame (const struct FrameReader * r, long index, uint64_t * cells, long * generation) {
+
+    unsigned char header[8];
+
+    if ((index < 0) || (index >= r->frames)) return -1;
+    const uint64_t offset = r->offsets[index];
+    if ((offset < FRAMES_HEADER) || ((offset + 8) > r->end)) return -1;
+    if (pread(r->fd, header, 8, offset) != 8) return -1;
+
+    const size_t length = frames_get(header + 4, 4);
+    if ((offset + 8 + length) > r->end) return -1;
+    if (generation != NULL) *generation = frames_get(header, 4);
+
+    const size_t size = (size_t) r->words * 8 * r->height;
+    unsigned char * data = malloc(length + 1);
+    unsigned char * raw = malloc(size);
+    int result = -1;
+
+    if (
+        (data != NULL) && (raw != NULL) &&
+        (pread(r->fd, data, length, offset + 8) == (ssize_t) length) &&
+        (decode_frame(data, length, raw, size) == 0)
+    ) {
+        for (size_t iLauf = 0; iLauf < (size / 8); iLauf ++) {
+            cells[iLauf] = frames_get(raw + 8 * iLauf, 8);
+        }
+        result = 0;
+    }
+
+    free(data);
+    free(raw);
+    return result;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Compress size Bytes into data (which needs Space for size + 32 Bytes).
+// Returns the Length of the compressed Data.
+size_t encode_frame (const unsigned char * raw, size_t size, unsigned char * data) {
+
+    size_t length = 0, pos = 0;
+
+    while (pos < size) {
+        // Zeros
+        size_t start = pos;
+        while ((pos < size) && (raw[pos] == 0)) pos ++;
+        length += put_varint(data + length, pos - start);
+        if (pos == size) break;
+
+        // Literals until the next long Zero Run (or the End)
+        start = pos;
+        while (pos < size) {
+            if (raw[pos] == 0) {
+                size_t zeros = 1;
+                while (((pos + zeros) < size) && (raw[pos + zeros] == 0) && (zeros < FRAMES_MIN_ZEROS)) {
+                    zeros ++;
+                }
+                if ((zeros >= FRAMES_MIN_ZEROS) || ((pos + zeros) == size)) break;
+                pos += zeros;
+            } else {
+                pos ++;
+            }
+        }
+        length += put_varint(data + length, pos - start);
+        memcpy(data + length, raw + start, pos - start);
+        length += pos - start;
+    }
+
+    return length;
+
+}
+
+// Decompress length Bytes of data into exactly size Bytes.
+// Returns -1 if the Data is corrupt.
+int decode_frame (const unsigned char * data, size_t length, unsigned char * raw, size_t size) {
+
+    size_t pos = 0, out = 0;
+    uint64_t zeros, literals;
+
+    while (pos < length) {
+        if ((get_varint(data, length, &pos, &zeros) < 0) || (zeros > (size - out))) return -1;
+        memset(raw + out, 0, zeros);
+        out += zeros;
+        if (pos == length) break;
+
+        if ((get_varint(data, length, &pos, &literals) < 0) || (literals > (size - out))) return -1;
+        if (literals > (length - pos)) return -1;
+        memcpy(raw + out, data + pos, literals);
+        out += literals;
+        pos += literals;
+    }
+
+    return (out == size) ? 0 : -1;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Store the lowest Bytes of value (Little Endian)
+static void frames_put (unsigned char * buffer, uint64_t value, int bytes) {
+    for (int iLauf = 0; iLauf < bytes; iLauf ++) {
+        buffer[iLauf] = (value >> (8 * iLauf)) & 0xFF;
+    }
+}
+
+static uint64_t frames_get (const unsigned char * buffer, int bytes) {
+    uint64_t value = 0;
+    for (int iLauf = 0; iLauf < bytes; iLauf ++) {
+        value |= (uint64_t) buffer[iLauf] << (8 * iLauf);
+    }
+    return value;
+}
+
+// Store value using 7 Bits per Byte (the highest Bit marks that more follow).
+// Returns the Number of Bytes.
+static size_t put_varint (unsigned char * data, uint64_t value) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        data[length ++] = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    data[length ++] = value;
+    return length;
+}
+
+// Returns -1 if the Varint goes past the End or has more than 64 Bits
+static int get_varint (const unsigned char * data, size_t length, size_t * pos, uint64_t * value) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (*pos >= length) return -1;
+        const unsigned char byte = data[(*pos) ++];
+        *value |= (uint64_t) (byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return 0;
+    }
+    return -1;
+}
+
+// -------------------------------------------------------------------------- //
@@ -0,0 +1,344 @@
+
+// -------------------------------------------------------------------------- //
+// --- Explanation ---------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Animated GIF which is written while the Game runs, one Frame per
+// Generation, without any temporary Files or external Tools:
+//
+//      ./game 50 40 0.3 500 --gif gol.gif --gif-scale 4 --gif-delay 100
+//
+// Every Cell becomes a Square of scale x scale Pixels (alive => black,
+// dead => white). The Frames are made from the packed Board (Bit x of Row y
+// is Bit x % 64 of Word x / 64), like the Views of the Terminal.
+//
+// Only the first Frame holds the whole Board. Every following Frame only
+// covers the Bounding Box of the Cells which changed since the Frame before
+// and is drawn on top of it. Inside the Box the unchanged Cells are
+// transparent, so the Image Data mostly consists of long Runs of the same
+// Colour, which LZW compresses very well.
+//
+// The Palette only has 4 Colours (dead, alive, transparent, unused), so the
+// LZW-Dictionary is a Trie with 4 Children per Code and a Lookup is a
+// single Array Access instead of a Hash.
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Colours of the Palette
+#define GIF_DEAD 0
+#define GIF_ALIVE 1
+#define GIF_TRANSPARENT 2
+
+// Codes of the LZW-Stream for a 2 Bit Palette
+#define GIF_MIN_CODE_SIZE 2
+#define GIF_CLEAR_CODE 4
+#define GIF_END_CODE 5
+#define GIF_FIRST_CODE 6
+#define GIF_MAX_CODES 4096
+
+struct GifWriter {
+    FILE * file;
+    // Size of the Board in Cells
+    int width;
+    int height;
+    // Pixels per Cell in both Directions
+    int scale;
+    // Time each Frame is shown in 1/100 s
+    int delay;
+    // Words of a packed Row
+    long words;
+    // Last Frame, to find the changed Cells
+    uint64_t * previous;
+    bool first;
+    // Packed Board for Variants which store the Cells differently
+    uint64_t * bits;
+
+    // Dictionary of the LZW-Encoder: next[code * 4 + colour] is the Code of
+    // the String code + colour (0 => not in the Dictionary yet)
+    uint16_t * next;
+    int prefix;
+    int next_code;
+    int code_size;
+    // Bits which do not fill a Byte yet
+    uint32_t pending;
+    int pending_bits;
+    // Data Sub-Block which is filled right now
+    unsigned char block[255];
+    int block_length;
+};
+
+// -------------------------------------------------------------------------- //
+
+int open_gif (struct GifWriter * g, const char * path, int width, int height, int scale, int delay);
+int close_gif (struct GifWriter * g);
+int write_gif_frame (struct GifWriter * g, const uint64_t * cells, long stride);
+static void gif_word (FILE * file, int value);
+static void gif_start_lzw (struct GifWriter * g);
+static void gif_pixel (struct GifWriter * g, int colour);
+static void gif_finish_lzw (struct GifWriter * g);
+static void gif_code (struct GifWriter * g, int code);
+static void gif_byte (struct GifWriter * g, unsigned char byte);
+
+// -------------------------------------------------------------------------- //
+
+// Create the File and write the Header of the GIF.
+// delay is the Time each Frame is shown in ms.
+// Returns -1 if the Image would be too big, no Memory could be allocated or
+// the File could not be opened.
+int open_gif (struct GifWriter * g, const char * path, int width, int height, int scale, int delay) {
+
+    // The Size of the Image is stored in 16 Bits
+    if ((width <= 0) || (height <= 0) || (scale <= 0)) return -1;
+    if (((long) width * scale > 65535) || ((long) height * scale > 65535)) return -1;
+
+    g->width = width;
+    g->height = height;
+    g->scale = scale;
+    g->delay = (delay + 5) / 10;
+    g->words = (width + 63) / 64;
+    g->first = true;
+
+    g->previous = calloc((size_t) g->words * height, sizeof(uint64_t));
+    g->bits = calloc((size_t) g->words * height, sizeof(uint64_t));
+    g->next = malloc(sizeof(uint16_t) * GIF_MAX_CODES * 4);
+    g->file = NULL;
+    if ((g->previous == NULL) || (g->bits == NULL) || (g->next == NULL)) {
+        close_gif(g);
+        return -1;
+    }
+
+    g->file = fopen(path, "wb");
+    if (g->file == NULL) {
+        close_gif(g);
+        return -1;
+    }
+
+    // Logical Screen with a global Palette of 4 Colours
+    fputs("GIF89a", g->file);
+    gif_word(g->file, width * scale);
+    gif_word(g->file, height * scale);
+    fputc(0x80 | (1 << 4) | (GIF_MIN_CODE_SIZE - 1), g->file);
+    fputc(GIF_DEAD, g->file);
+    fputc(0, g->file);
+    const unsigned char palette[4][3] = {
+        [GIF_DEAD] = {0xFF, 0xFF, 0xFF},
+        [GIF_ALIVE] = {0x00, 0x00, 0x00},
+        [GIF_TRANSPARENT] = {0x80, 0x80, 0x80},
+        [3] = {0x80, 0x80, 0x80}
+    };
+    fwrite(palette, sizeof(palette), 1, g->file);
+
+    // Loop the Animation forever
+    fputs("\x21\xFF\x0B" "NETSCAPE2.0" "\x03\x01", g->file);
+    gif_word(g->file, 0);
+    fputc(0, g->file);
+
+    return ferror(g->file) ? -1 : 0;
+
+}
+
+// Write the End of the GIF, close the File and free the Buffers.
+// Does nothing if the GIF was never opened.
+// Returns -1 if the File could not be written.
+int close_gif (struct GifWriter * g) {
+
+    int result = 0;
+
+    if (g->file != NULL) {
+        fputc(0x3B, g->file);
+        if (ferror(g->file)) result = -1;
+        if (fclose(g->file) != 0) result = -1;
+    }
+
+    free(g->previous);
+    free(g->bits);
+    free(g->next);
+    g->file = NULL;
+    g->previous = NULL;
+    g->bits = NULL;
+    g->next = NULL;
+
+    return result;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Append the Board as the next Frame (stride Words from one Row to the next).
+// Returns -1 if the File could not be written.
+int write_gif_frame (struct GifWriter * g, const uint64_t * cells, long stride) {
+
+    // Bits behind the last Cell of a Row are ignored
+    const uint64_t last_mask = (g->width % 64) ? ((1ULL << (g->width % 64)) - 1) : ~0ULL;
+    long min_x = g->width, max_x = -1, min_y = g->height, max_y = -1;
+
+    // Find the Bounding Box of the changed Cells (the first Frame is whole)
+    if (g->first) {
+        min_x = 0;
+        max_x = g->width - 1;
+        min_y = 0;
+        max_y = g->height - 1;
+    } else {
+        for (long iLauf = 0; iLauf < g->height; iLauf ++) {
+            const uint64_t * row = cells + iLauf * stride;
+            const uint64_t * old = g->previous + iLauf * g->words;
+            long first = -1, last = -1;
+            for (long iLauf2 = 0; iLauf2 < g->words; iLauf2 ++) {
+                uint64_t diff = row[iLauf2] ^ old[iLauf2];
+                if (iLauf2 == (g->words - 1)) diff &= last_mask;
+                if (diff == 0) continue;
+                if (first < 0) first = 64 * iLauf2 + __builtin_ctzll(diff);
+                last = 64 * iLauf2 + 63 - __builtin_clzll(diff);
+            }
+            if (first < 0) continue;
+            if (first < min_x) min_x = first;
+            if (last > max_x) max_x = last;
+            if (iLauf < min_y) min_y = iLauf;
+            max_y = iLauf;
+        }
+    }
+
+    // Nothing changed => A single transparent Pixel keeps the Timing
+    const bool unchanged = max_y < 0;
+    const long left = unchanged ? 0 : min_x * g->scale;
+    const long top = unchanged ? 0 : min_y * g->scale;
+    const long frame_width = unchanged ? 1 : (max_x - min_x + 1) * g->scale;
+    const long frame_height = unchanged ? 1 : (max_y - min_y + 1) * g->scale;
+
+    // Graphic Control Extension: Keep the Frame before, transparent Colour
+    fputs("\x21\xF9\x04", g->file);
+    fputc((1 << 2) | 1, g->file);
+    gif_word(g->file, g->delay);
+    fputc(GIF_TRANSPARENT, g->file);
+    fputc(0, g->file);
+
+    // Image Descriptor (without a local Palette)
+    fputc(0x2C, g->file);
+    gif_word(g->file, left);
+    gif_word(g->file, top);
+    gif_word(g->file, frame_width);
+    gif_word(g->file, frame_height);
+    fputc(0, g->file);
+
+    gif_start_lzw(g);
+    if (unchanged) {
+        gif_pixel(g, GIF_TRANSPARENT);
+    } else {
+        for (long iLauf = min_y; iLauf <= max_y; iLauf ++) {
+            const uint64_t * row = cells + iLauf * stride;
+            const uint64_t * old = g->previous + iLauf * g->words;
+            for (int iLauf2 = 0; iLauf2 < g->scale; iLauf2 ++) {
+                for (long x = min_x; x <= max_x; x ++) {
+                    const uint64_t bit = 1ULL << (x % 64);
+                    const bool alive = row[x / 64] & bit;
+                    int colour = alive ? GIF_ALIVE : GIF_DEAD;
+                    if (!g->first && (alive == ((old[x / 64] & bit) != 0))) colour = GIF_TRANSPARENT;
+                    for (int iLauf3 = 0; iLauf3 < g->scale; iLauf3 ++) gif_pixel(g, colour);
+                }
+            }
+        }
+    }
+    gif_finish_lzw(g);
+
+    // Remember the Frame for the next one
+    for (long iLauf = min_y; iLauf <= max_y; iLauf ++) {
+        memcpy(g->previous + iLauf * g->words, cells + iLauf * stride, sizeof(uint64_t) * g->words);
+    }
+    g->first = false;
+
+    return ferror(g->file) ? -1 : 0;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Write a 16 Bit Value (Little Endian)
+static void gif_word (FILE * file, int value) {
+    fputc(value & 0xFF, file);
+    fputc((value >> 8) & 0xFF, file);
+}
+
+static void gif_start_lzw (struct GifWriter * g) {
+    fputc(GIF_MIN_CODE_SIZE, g->file);
+    memset(g->next, 0, sizeof(uint16_t) * GIF_MAX_CODES * 4);
+    g->prefix = -1;
+    g->next_code = GIF_FIRST_CODE;
+    g->code_size = GIF_MIN_CODE_SIZE + 1;
+    g->pending = 0;
+    g->pending_bits = 0;
+    g->block_length = 0;
+    gif_code(g, GIF_CLEAR_CODE);
+}
+
+// Add a Pixel to the Image Data
+static void gif_pixel (struct GifWriter * g, int colour) {
+
+    if (g->prefix < 0) {
+        g->prefix = colour;
+        return;
+    }
+
+    // Extend the String as long as it is in the Dictionary
+    uint16_t * child = &g->next[g->prefix * 4 + colour];
+    if (*child != 0) {
+        g->prefix = *child;
+        return;
+    }
+
+    gif_code(g, g->prefix);
+    *child = g->next_code ++;
+    if (g->next_code == GIF_MAX_CODES) {
+        // The Dictionary is full => Start over
+        gif_code(g, GIF_CLEAR_CODE);
+        memset(g->next, 0, sizeof(uint16_t) * GIF_MAX_CODES * 4);
+        g->next_code = GIF_FIRST_CODE;
+        g->code_size = GIF_MIN_CODE_SIZE + 1;
+    } else if (g->next_code > (1 << g->code_size)) {
+        g->code_size ++;
+    }
+    g->prefix = colour;
+
+}
+
+// Write the last String and the End of the Image Data
+static void gif_finish_lzw (struct GifWriter * g) {
+
+    gif_code(g, g->prefix);
+    // The Decoder adds one more Code after reading the last String, which
+    // might make the End-Code one Bit longer
+    if ((g->next_code == (1 << g->code_size)) && (g->code_size < 12)) g->code_size ++;
+    gif_code(g, GIF_END_CODE);
+
+    if (g->pending_bits > 0) gif_byte(g, g->pending);
+    if (g->block_length > 0) {
+        fputc(g->block_length, g->file);
+        fwrite(g->block, 1, g->block_length, g->file);
+    }
+    // Empty Sub-Block => End of the Image Data
+    fputc(0, g->file);
+
+}
+
+static void gif_code (struct GifWriter * g, int code) {
+    g->pending |= (uint32_t) code << g->pending_bits;
+    g->pending_bits += g->code_size;
+    while (g->pending_bits >= 8) {
+        gif_byte(g, g->pending & 0xFF);
+        g->pending >>= 8;
+        g->pending_bits -= 8;
+    }
+}
+
+// Add a Byte to the current Sub-Block, which is written once it is full
+static void gif_byte (struct GifWriter * g, unsigned char byte) {
+    g->block[g->block_length ++] = byte;
+    if (g->block_length == 255) {
+        fputc(255, g->file);
+        fwrite(g->block, 1, 255, g->file);
+        g->block_length = 0;
+    }
+}
+
+// -------------------------------------------------------------------------- //
@@ -0,0 +1,227 @@
+
+// -------------------------------------------------------------------------- //
+// --- Explanation ---------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Implementation of the Library (see gol.h), which is built on its own
+// instead of through game.c. It only includes the Parts of the Packed
+// Variant a single Board needs, which keep all of their State in the Board
+// (no Options, Scheduler, Terminal or Files).
+//
+// Every Board keeps the Kernel of its Rule (see select_kernel), which also
+// holds the Masks of the generic Kernel.
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+#define GOL_BUILD
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "gol.h"
+
+#define TRUE true
+#define FALSE false
+
+#define DEAD_EDGES 0
+#define TORUS 1
+
+// What lies beyond the Edges of the Board (see game.c)
+#ifndef TOPOLOGY
+    #define TOPOLOGY DEAD_EDGES
+#endif
+
+#define UNUSED(x) (void)(x)
+
+// Boards of the Library do not collect Statistics
+#define BITSLICE_STATS FALSE
+
+#include "rule.c"
+#include "bitmap.c"
+#include "bitslice.c"
+
+// -------------------------------------------------------------------------- //
+
+struct GolBoard {
+    struct Rule rule;
+    struct Kernel kernel;
+    // The current Generation is boards[current]
+    struct Bitmap boards[2];
+    int current;
+    long generation;
+};
+
+// -------------------------------------------------------------------------- //
+
+int gol_create (GolBoard ** board, int width, int height, const char * rule) {
+
+    if ((board == NULL) || (width <= 0) || (height <= 0)) return GOL_ERROR_ARGUMENT;
+    *board = NULL;
+
+    GolBoard * b = calloc(1, sizeof(GolBoard));
+    if (b == NULL) return GOL_ERROR_MEMORY;
+
+    if (parse_rule((rule != NULL) ? rule : "B3/S23", &b->rule) < 0) {
+        free(b);
+        return GOL_ERROR_RULE;
+    }
+    b->kernel = select_kernel(&b->rule, false);
+
+    if (init_bitmap(&b->boards[0], width, height) < 0) {
+        free(b);
+        return GOL_ERROR_MEMORY;
+    }
+    if (init_bitmap(&b->boards[1], width, height) < 0) {
+        uninit_bitmap(&b->boards[0]);
+        free(b);
+        return GOL_ERROR_MEMORY;
+    }
+
+    *board = b;
+    return GOL_OK;
+
+}
+
+void gol_destroy (GolBoard * board) {
+    if (board == NULL) return;
+    uninit_bitmap(&board->boards[0]);
+    uninit_bitmap(&board->boards[1]);
+    free(board);
+}
+
+// -------------------------------------------------------------------------- //
+
+int gol_width (const GolBoard * board) {
+    return (board != NULL) ? board->boards[0].width : 0;
+}
+
+int gol_height (const GolBoard * board) {
+    return (board != NULL) ? board->boards[0].height : 0;
+}
+
+long gol_generation (const GolBoard * board) {
+    return (board != NULL) ? board->generation : 0;
+}
+
+long gol_population (const GolBoard * board) {
+    if (board == NULL) return 0;
+    const struct Bitmap * b = &board->boards[board->current];
+    long population = 0;
+    for (long iLauf = 0; iLauf < b->height; iLauf ++) {
+        const u64 * row = bitmap_row(b, iLauf);
+        for (long iLauf2 = 0; iLauf2 < b->words; iLauf2 ++) {
+            // On a Torus the Padding can hold a Copy of the first Cell
+            const u64 mask = (iLauf2 == (b->words - 1)) ? b->tail_mask : ~0ULL;
+            population += __builtin_popcountll(row[iLauf2] & mask);
+        }
+    }
+    return population;
+}
+
+// -------------------------------------------------------------------------- //
+
+int gol_get (const GolBoard * board, int x, int y) {
+    if ((board == NULL) || (x < 0) || (y < 0)) return 0;
+    const struct Bitmap * b = &board->boards[board->current];
+    if ((x >= b->width) || (y >= b->height)) return 0;
+    return get_bit(b, x, y);
+}
+
+int gol_set (GolBoard * board, int x, int y, int alive) {
+    if ((board == NULL) || (x < 0) || (y < 0)) return GOL_ERROR_ARGUMENT;
+    struct Bitmap * b = &board->boards[board->current];
+    if ((x >= b->width) || (y >= b->height)) return GOL_ERROR_ARGUMENT;
+    set_bit(b, x, y, alive != 0);
+    return GOL_OK;
+}
+
+int gol_clear (GolBoard * board) {
+    if (board == NULL) return GOL_ERROR_ARGUMENT;
+    struct Bitmap * b = &board->boards[board->current];
+    memset(b->memory, 0, sizeof(u64) * b->capacity);
+    return GOL_OK;
+}
+
+int gol_fill_random (GolBoard * board, double density, unsigned long long seed) {
+    if ((board == NULL) || !(density >= 0) || (density > 1)) return GOL_ERROR_ARGUMENT;
+    gol_clear(board);
+    fill_bitmap(&board->boards[board->current], density, seed);
+    return GOL_OK;
+}
+
+// -------------------------------------------------------------------------- //
+
+int gol_step (GolBoard * board, long generations) {
+
+    if ((board == NULL) || (generations < 0)) return GOL_ERROR_ARGUMENT;
+
+    for (long iLauf = 0; iLauf < generations; iLauf ++) {
+        struct Bitmap * src = &board->boards[board->current];
+        struct Bitmap * dest = &board->boards[1 - board->current];
+        exchange_bitmap_halo(src);
+        run_kernel(&board->kernel, src, dest, 0, src->height, 0, src->words, NULL);
+        board->current = 1 - board->current;
+        board->generation ++;
+    }
+
+    return GOL_OK;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+int gol_for_each_alive (const GolBoard * board, GolCellCallback callback, void * ctx) {
+
+    if ((board == NULL) || (callback == NULL)) return GOL_ERROR_ARGUMENT;
+
+    const struct Bitmap * b = &board->boards[board->current];
+    for (long iLauf = 0; iLauf < b->height; iLauf ++) {
+        const u64 * row = bitmap_row(b, iLauf);
+        for (long iLauf2 = 0; iLauf2 < b->words; iLauf2 ++) {
+            u64 word = row[iLauf2];
+            if (iLauf2 == (b->words - 1)) word &= b->tail_mask;
+            for (; word != 0; word &= word - 1) {
+                const int result = callback(ctx, iLauf2 * 64 + __builtin_ctzll(word), iLauf);
+                if (result != 0) return result;
+            }
+        }
+    }
+
+    return GOL_OK;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+int gol_rows (const GolBoard * board, GolRows * view) {
+
+    if ((board == NULL) || (view == NULL)) return GOL_ERROR_ARGUMENT;
+
+    const struct Bitmap * b = &board->boards[board->current];
+    view->rows = bitmap_row(b, 0);
+    view->stride = b->stride;
+    view->words = b->words;
+    view->tail_mask = b->tail_mask;
+
+    return GOL_OK;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+const char * gol_error_string (int error) {
+    switch (error) {
+        case GOL_OK: return "No Error";
+        case GOL_ERROR_MEMORY: return "No Memory could be allocated";
+        case GOL_ERROR_ARGUMENT: return "Invalid Argument";
+        case GOL_ERROR_RULE: return "Invalid Rule (expected B/S-Notation, e.g. B3/S23)";
+        default: return "Unknown Error";
+    }
+}
+
+// -------------------------------------------------------------------------- //
@@ -0,0 +1,116 @@
+
+// -------------------------------------------------------------------------- //
+// --- Explanation ---------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Library Interface of the Game of Life, for Programs which want to play
+// Boards themselves instead of running the game-Executable. It uses the
+// Engine of the Packed Variant (Bit-packed Boards and Bit-sliced Kernels).
+//
+// Building (see Makefile):
+//
+//      make lib        => libgol.a and libgol.so
+//      make lib-test   => Check the Library (see lib_test.c)
+//      cc app.c -Isrc -L. -lgol
+//
+// Usage Manual:
+//
+//      => gol_create(&board, width, height, rule)
+//              Create an empty Board (rule = NULL => "B3/S23")
+//      => gol_set(board, x, y, alive) / gol_get(board, x, y)
+//              Change/Read a single Cell
+//      => gol_fill_random(board, density, seed)
+//              Replace the Cells with a random Soup (the same Seed always
+//              gives the same Soup, also the same as in --batch)
+//      => gol_step(board, generations)
+//              Calculate the next Generations
+//      => gol_for_each_alive(board, callback, ctx)
+//              Call callback(ctx, x, y) for every alive Cell, Row by Row
+//      => gol_rows(board, &view)
+//              Read the Cells in place, 64 Cells per Word (see GolRows)
+//      => gol_destroy(board)
+//              Free the Board
+//
+// Functions which can fail return GOL_OK or one of the (negative) Errors,
+// gol_error_string describes them. The Library never exits the Program.
+// Every Board is independent, so different Boards can be used from
+// different Threads at the same Time (one Board by one Thread at a Time).
+// The Cells outside of the Board are dead, unless the Library was built
+// with -DTOPOLOGY=TORUS.
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+#ifndef GOL_H
+#define GOL_H
+
+#include <stdint.h>
+
+// Only the Functions of this Header are exported by the shared Library
+#if defined(GOL_BUILD) && defined(__GNUC__)
+    #define GOL_API __attribute__((visibility("default")))
+#else
+    #define GOL_API
+#endif
+
+typedef struct GolBoard GolBoard;
+
+enum GolError {
+    GOL_OK = 0,
+    // No Memory could be allocated
+    GOL_ERROR_MEMORY = -1,
+    // A Size, Coordinate, Density or Count is out of Range (or NULL)
+    GOL_ERROR_ARGUMENT = -2,
+    // The Rule is not in the B/S-Notation
+    GOL_ERROR_RULE = -3
+};
+
+// Returns 0 from the Callback to continue, anything else to stop
+typedef int (* GolCellCallback)(void * ctx, int x, int y);
+
+// Read-only View of the current Generation without copying it:
+//
+//      const uint64_t * row = view.rows + y * view.stride;
+//      alive = (row[x / 64] >> (x % 64)) & 1;
+//
+// The Bits of row[words - 1] beyond the Width are not Cells, mask them with
+// tail_mask. The View stays valid until the Board is changed (gol_step,
+// gol_set, gol_clear, ...) or destroyed.
+typedef struct GolRows {
+    const uint64_t * rows;
+    // Distance between two Rows in Words
+    long stride;
+    // Number of Words holding Cells in each Row
+    long words;
+    uint64_t tail_mask;
+} GolRows;
+
+// -------------------------------------------------------------------------- //
+
+GOL_API int gol_create (GolBoard ** board, int width, int height, const char * rule);
+GOL_API void gol_destroy (GolBoard * board);
+
+GOL_API int gol_width (const GolBoard * board);
+GOL_API int gol_height (const GolBoard * board);
+// Generations calculated since the Board was created
+GOL_API long gol_generation (const GolBoard * board);
+GOL_API long gol_population (const GolBoard * board);
+
+// Returns 1 if the Cell is alive, 0 if it is dead (or an Error)
+GOL_API int gol_get (const GolBoard * board, int x, int y);
+GOL_API int gol_set (GolBoard * board, int x, int y, int alive);
+GOL_API int gol_clear (GolBoard * board);
+GOL_API int gol_fill_random (GolBoard * board, double density, unsigned long long seed);
+
+GOL_API int gol_step (GolBoard * board, long generations);
+
+// Returns GOL_OK or the first Value other than 0 the Callback returned
+GOL_API int gol_for_each_alive (const GolBoard * board, GolCellCallback callback, void * ctx);
+GOL_API int gol_rows (const GolBoard * board, GolRows * view);
+
+GOL_API const char * gol_error_string (int error);
+
+// -------------------------------------------------------------------------- //
+
+#endif
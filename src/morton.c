@@ -0,0 +1,264 @@
+
+// -------------------------------------------------------------------------- //
+// --- Explanation ---------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Tiled Storage for a Board of bools, where the Tiles are stored in Z-Order
+// (Morton-Order) instead of storing the Board Row by Row.
+//
+// In a Board stored Row by Row the Cells above and below a Cell are a whole
+// Row apart, so a big Board touches a lot of Pages in every Step. Here the
+// Board is cut into Tiles of MORTON_TILE x MORTON_TILE Cells. Each Tile is
+// stored in one Piece (Row by Row, with its own Ring of Ghost Cells) and the
+// Tiles are ordered along a Z-Curve, so Tiles which are close on the Board
+// are also close in Memory:
+//
+//      Tiles:  0  1  4  5
+//              2  3  6  7
+//              8  9 12 13
+//             10 11 14 15
+//
+// If the Board does not have a Power of 2 Tiles in each Direction the Tiles
+// outside of the Board are simply skipped.
+// The Memory is mapped directly and the Kernel is asked to back it with
+// 2 MB Huge Pages (if that is not possible normal Pages are used).
+//
+// Before every Generation exchange_morton_tile copies the Edges of the
+// neighbouring Tiles into the Ghost Cells of a Tile, so the Kernels can
+// calculate each Tile just like a small Board.
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+#include <sys/mman.h>
+
+// Width and Height of a Tile in Cells
+#ifndef MORTON_TILE
+    #define MORTON_TILE 64
+#endif
+// Distance between two Rows of a Tile (including the Ghost Cells)
+#define MORTON_STRIDE (MORTON_TILE + 2)
+
+#define HUGE_PAGE_SIZE (2UL << 20)
+
+struct MortonGrid {
+    int width;
+    int height;
+    int tiles_x;
+    int tiles_y;
+    // Position of every Tile in Memory (Index = ty * tiles_x + tx)
+    long * slots;
+    bool * cells;
+    // Mapped Memory (cells is aligned to a Huge Page inside of it)
+    void * mapping;
+    size_t mapping_size;
+};
+
+// -------------------------------------------------------------------------- //
+
+int init_morton (struct MortonGrid * g, int width, int height);
+void uninit_morton (struct MortonGrid * g);
+bool * morton_tile (const struct MortonGrid * g, int tx, int ty);
+int morton_tile_width (const struct MortonGrid * g, int tx);
+int morton_tile_height (const struct MortonGrid * g, int ty);
+void morton_rows (const struct MortonGrid * g, int tx, int ty, bool ** rows);
+void exchange_morton_tile (struct MortonGrid * g, int tx, int ty);
+void morton_from_rows (struct MortonGrid * g, bool ** cells);
+void morton_to_rows (const struct MortonGrid * g, bool ** cells);
+static uint64_t interleave_bits (uint32_t x, uint32_t y);
+static int compare_codes (const void * a, const void * b);
+
+// -------------------------------------------------------------------------- //
+
+// Allocate an empty Grid for a Board of the given Size.
+// Returns -1 if the Size is invalid or no Memory could be allocated.
+int init_morton (struct MortonGrid * g, int width, int height) {
+
+    if ((g == NULL) || (width <= 0) || (height <= 0)) return -1;
+
+    g->width = width;
+    g->height = height;
+    g->tiles_x = (width + MORTON_TILE - 1) / MORTON_TILE;
+    g->tiles_y = (height + MORTON_TILE - 1) / MORTON_TILE;
+
+    long num_tiles = (long) g->tiles_x * g->tiles_y;
+
+    // Sort the Tiles by their Position on the Z-Curve to get their Slots
+    uint64_t (* codes)[2] = malloc(sizeof(uint64_t[2]) * num_tiles);
+    g->slots = malloc(sizeof(long) * num_tiles);
+    if ((codes == NULL) || (g->slots == NULL)) {
+        free(codes);
+        free(g->slots);
+        return -1;
+    }
+    for (long iLauf = 0; iLauf < num_tiles; iLauf ++) {
+        codes[iLauf][0] = interleave_bits(iLauf % g->tiles_x, iLauf / g->tiles_x);
+        codes[iLauf][1] = iLauf;
+    }
+    qsort(codes, num_tiles, sizeof(codes[0]), compare_codes);
+    for (long iLauf = 0; iLauf < num_tiles; iLauf ++) {
+        g->slots[codes[iLauf][1]] = iLauf;
+    }
+    free(codes);
+
+    // Map an extra Huge Page, so the Cells can start on a Huge Page Boundary.
+    // Mapped Memory is zeroed, so all Cells (and Ghost Cells) start dead.
+    size_t size = sizeof(bool) * num_tiles * MORTON_STRIDE * MORTON_STRIDE;
+    g->mapping_size = size + HUGE_PAGE_SIZE;
+    g->mapping = mmap(
+        NULL, g->mapping_size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0
+    );
+    if (g->mapping == MAP_FAILED) {
+        free(g->slots);
+        return -1;
+    }
+    g->cells = (bool *) (((uintptr_t) g->mapping + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1));
+
+    // Only a Hint, the Grid works the same without Huge Pages.
+    madvise(g->cells, size, MADV_HUGEPAGE);
+
+    return 0;
+
+}
+
+void uninit_morton (struct MortonGrid * g) {
+    if ((g == NULL) || (g->cells == NULL)) return;
+    munmap(g->mapping, g->mapping_size);
+    free(g->slots);
+    g->cells = NULL;
+}
+
+// -------------------------------------------------------------------------- //
+
+// Get the Cell (0, 0) of the Tile, the Ghost Cells are at the Index -1 and
+// MORTON_STRIDE is the Distance between the Rows.
+bool * morton_tile (const struct MortonGrid * g, int tx, int ty) {
+    long slot = g->slots[(long) ty * g->tiles_x + tx];
+    return g->cells + slot * MORTON_STRIDE * MORTON_STRIDE + MORTON_STRIDE + 1;
+}
+
+// Size of the Tile (the Tiles on the right and lower Edge can be smaller)
+int morton_tile_width (const struct MortonGrid * g, int tx) {
+    int width = g->width - tx * MORTON_TILE;
+    return (width < MORTON_TILE) ? width : MORTON_TILE;
+}
+
+int morton_tile_height (const struct MortonGrid * g, int ty) {
+    int height = g->height - ty * MORTON_TILE;
+    return (height < MORTON_TILE) ? height : MORTON_TILE;
+}
+
+// Fill rows (MORTON_STRIDE Entries) with Pointers to the Rows of the Tile,
+// so that (rows + 1) can be used like a Board with Ghost Cells.
+void morton_rows (const struct MortonGrid * g, int tx, int ty, bool ** rows) {
+    bool * tile = morton_tile(g, tx, ty);
+    for (int iLauf = 0; iLauf < MORTON_STRIDE; iLauf ++) {
+        rows[iLauf] = tile + (iLauf - 1) * MORTON_STRIDE;
+    }
+}
+
+// -------------------------------------------------------------------------- //
+
+// Copy the Edges of the 8 neighbouring Tiles into the Ghost Cells of the Tile.
+// Only the Ghost Cells of the Tile itself are written, so all Tiles can be
+// exchanged at the same Time.
+void exchange_morton_tile (struct MortonGrid * g, int tx, int ty) {
+
+    bool * self = morton_tile(g, tx, ty);
+    const int width = morton_tile_width(g, tx);
+    const int height = morton_tile_height(g, ty);
+
+    for (int dy = -1; dy <= 1; dy ++) {
+        for (int dx = -1; dx <= 1; dx ++) {
+            if ((dx == 0) && (dy == 0)) continue;
+
+            int ox = tx + dx;
+            int oy = ty + dy;
+            #if TOPOLOGY == TORUS
+                ox = (ox + g->tiles_x) % g->tiles_x;
+                oy = (oy + g->tiles_y) % g->tiles_y;
+            #else
+                // Beyond the Edge the Ghost Cells stay dead
+                if ((ox < 0) || (ox >= g->tiles_x) || (oy < 0) || (oy >= g->tiles_y)) continue;
+            #endif
+            const bool * other = morton_tile(g, ox, oy);
+
+            // Part of the Ghost Ring and the Cells of the other Tile it gets
+            const int x_dest = (dx < 0) ? -1 : ((dx == 0) ? 0 : width);
+            const int x_src = (dx < 0) ? (morton_tile_width(g, ox) - 1) : 0;
+            const int count_x = (dx == 0) ? width : 1;
+            const int y_dest = (dy < 0) ? -1 : ((dy == 0) ? 0 : height);
+            const int y_src = (dy < 0) ? (morton_tile_height(g, oy) - 1) : 0;
+            const int count_y = (dy == 0) ? height : 1;
+
+            for (int iLauf = 0; iLauf < count_y; iLauf ++) {
+                memcpy(
+                    self + (y_dest + iLauf) * MORTON_STRIDE + x_dest,
+                    other + (y_src + iLauf) * MORTON_STRIDE + x_src,
+                    sizeof(bool) * count_x
+                );
+            }
+        }
+    }
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Copy a Board stored Row by Row (like the ones of init) into the Grid
+void morton_from_rows (struct MortonGrid * g, bool ** cells) {
+    for (int ty = 0; ty < g->tiles_y; ty ++) {
+        for (int tx = 0; tx < g->tiles_x; tx ++) {
+            bool * tile = morton_tile(g, tx, ty);
+            const int width = morton_tile_width(g, tx);
+            const int height = morton_tile_height(g, ty);
+            for (int iLauf = 0; iLauf < height; iLauf ++) {
+                memcpy(
+                    tile + iLauf * MORTON_STRIDE,
+                    cells[ty * MORTON_TILE + iLauf] + tx * MORTON_TILE,
+                    sizeof(bool) * width
+                );
+            }
+        }
+    }
+}
+
+// Copy the Grid into a Board stored Row by Row, e.g. to display it
+void morton_to_rows (const struct MortonGrid * g, bool ** cells) {
+    for (int ty = 0; ty < g->tiles_y; ty ++) {
+        for (int tx = 0; tx < g->tiles_x; tx ++) {
+            const bool * tile = morton_tile(g, tx, ty);
+            const int width = morton_tile_width(g, tx);
+            const int height = morton_tile_height(g, ty);
+            for (int iLauf = 0; iLauf < height; iLauf ++) {
+                memcpy(
+                    cells[ty * MORTON_TILE + iLauf] + tx * MORTON_TILE,
+                    tile + iLauf * MORTON_STRIDE,
+                    sizeof(bool) * width
+                );
+            }
+        }
+    }
+}
+
+// -------------------------------------------------------------------------- //
+
+// Position on the Z-Curve: the Bits of x and y alternate (x in the even Bits)
+static uint64_t interleave_bits (uint32_t x, uint32_t y) {
+    uint64_t code = 0;
+    for (int iLauf = 0; iLauf < 32; iLauf ++) {
+        code |= (uint64_t) ((x >> iLauf) & 1) << (2 * iLauf);
+        code |= (uint64_t) ((y >> iLauf) & 1) << (2 * iLauf + 1);
+    }
+    return code;
+}
+
+static int compare_codes (const void * a, const void * b) {
+    const uint64_t * code_a = a;
+    const uint64_t * code_b = b;
+    return (code_a[0] > code_b[0]) - (code_a[0] < code_b[0]);
+}
+
+// -------------------------------------------------------------------------- //
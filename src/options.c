@@ -0,0 +1,262 @@
+
+// -------------------------------------------------------------------------- //
+// --- Explanation ---------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Optional Command Line Flags shared by all Variants.
+// They follow the 4 positional Arguments and can be written as "--flag value"
+// or "--flag=value":
+//
+//      ./game <width> <height> <density> <steps> [--rule B36/S23] [--stats out.csv]
+//             [--trace compare,new_chunk] [--trace-file trace.log]
+//             [--view braille] [--render-fps 30] [--render-thread]
+//             [--fps 60 | --delay-ms 250] [--gif gol.gif] [--gif-scale 4]
+//             [--gif-delay 100] [--frames run.golf] [--sparse run.gols]
+//             [--batch soups.txt [--census census.csv]]
+//
+// The parsed Options are stored in the global options-Struct, which starts
+// out with the Defaults, so Code which never parses the Command Line (e.g.
+// the Tests) still sees sensible Values.
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+#include "rule.c"
+#include "trace.c"
+#include "pacing.c"
+#include "render.c"
+#include "gif.c"
+#include "frames.c"
+#include "sparse.c"
+
+struct Options {
+    // Rule used to calculate the next Generation (--rule)
+    struct Rule rule;
+    // File the Statistics of every Generation are written to (--stats)
+    // NULL => No Statistics are collected
+    const char * stats_path;
+    // Categories of the Trace Points which are recorded (--trace)
+    unsigned trace;
+    // File the Trace is written to (--trace-file)
+    // NULL => STDERR
+    const char * trace_path;
+    // How the Board is shown on the Terminal (--view)
+    enum RenderMode view;
+    // Frames drawn per Second on the Terminal (--render-fps)
+    // 0 => Every Generation is drawn
+    int render_fps;
+    // Draw in a separate Thread while the Simulation runs at full Speed
+    // (--render-thread)
+    bool render_thread;
+    // Time between two Generations in ns (--fps, --delay-ms)
+    // -1 => Default of the Variant
+    long long delay;
+    // Animated GIF the Generations are written to (--gif)
+    // NULL => No GIF is written
+    const char * gif_path;
+    // Pixels per Cell of the GIF (--gif-scale)
+    int gif_scale;
+    // Time each Frame of the GIF is shown in ms (--gif-delay)
+    int gif_delay;
+    // Compressed Stream the Generations are written to (--frames)
+    // NULL => No Stream is written
+    const char * frames_path;
+    // Coordinates of the alive Cells every Generation is written to
+    // (--sparse, only Complicated)
+    // NULL => No Dump is written
+    const char * sparse_path;
+    // File listing the Boards played in Batch Mode (--batch, only Packed)
+    // NULL => A single Game is played
+    const char * batch_path;
+    // File the Objects left on the Boards of the Batch are counted in
+    // (--census, only with --batch)
+    // NULL => No Census
+    const char * census_path;
+};
+
+struct Options options = {
+    .rule = CONWAY_RULE,
+    .stats_path = NULL,
+    .trace = 0,
+    .trace_path = NULL,
+    .view = RENDER_CELLS,
+    .render_fps = 0,
+    .render_thread = false,
+    .delay = -1,
+    .gif_path = NULL,
+    .gif_scale = 4,
+    .gif_delay = 100,
+    .frames_path = NULL,
+    .sparse_path = NULL,
+    .batch_path = NULL,
+    .census_path = NULL
+};
+
+// -------------------------------------------------------------------------- //
+
+void printUsage(const char* programName);
+int parse_options (int argc, char * argv[], struct Options * options);
+long long pace_interval (const struct Options * options, long default_ms);
+static const char * option_value (int argc, char * argv[], int * idx, const char * name);
+static int option_number (const char * value, long min, long max, long * number);
+
+// -------------------------------------------------------------------------- //
+
+void printUsage(const char* programName) {
+    printf("usage: %s <width> <height> <density> <steps> [options]\n", programName);
+    printf("options:\n");
+    printf("\t--rule <B../S..>    Life-like Rule in B/S-Notation (default B3/S23)\n");
+    printf("\t--stats <file>      Write Statistics of every Generation as CSV\n");
+    printf("\t                    (or JSON-Lines if the File ends with .json/.jsonl)\n");
+    printf("\t--trace <list>      Record the Trace Points of these Categories (or all):\n");
+    printf("\t                    iterator, compare, neighbours, create_temp, revive, kill,\n");
+    printf("\t                    redirection, cell_assign, cell_remove, new_chunk,\n");
+    printf("\t                    free_chunks, steal\n");
+    printf("\t--trace-file <file> Write the Trace to a File instead of STDERR\n");
+    printf("\t--view <mode>       Show the Board on the Terminal as cells (default),\n");
+    printf("\t                    half (Half Blocks) or braille, scaled to fit\n");
+    printf("\t--render-fps <n>    Draw at most n Frames per Second on the Terminal\n");
+    printf("\t--render-thread     Draw in a separate Thread (default %d Frames per Second)\n", RENDER_THREAD_FPS);
+    printf("\t                    while the Generations are calculated without Delay\n");
+    printf("\t--fps <n>           Calculate n Generations per Second\n");
+    printf("\t--delay-ms <n>      Wait n ms between two Generations (0 = no Delay)\n");
+    printf("\t--gif <file>        Write the Generations as an animated GIF\n");
+    printf("\t                    (instead of the .pbm Files)\n");
+    printf("\t--gif-scale <n>     Pixels per Cell in the GIF (default 4)\n");
+    printf("\t--gif-delay <ms>    Time each Frame of the GIF is shown (default 100)\n");
+    printf("\t--frames <file>     Write the Generations as a compressed Frame Stream\n");
+    printf("\t                    (instead of the .pbm Files)\n");
+    printf("\t--sparse <file>     Write the Coordinates of all alive Cells of every\n");
+    printf("\t                    Generation (only the unbounded Complicated Variant)\n");
+    printf("\t--batch <file>      Play every Board of the File (one \"<seed> [<width>\n");
+    printf("\t                    <height> [<density> [<steps>]]]\" per Line) on all\n");
+    printf("\t                    Threads and write a Summary per Board (only Packed)\n");
+    printf("\t--census <file>     Count the Still Lifes, Oscillators and Spaceships left\n");
+    printf("\t                    on the Boards of the Batch\n");
+}
+
+// -------------------------------------------------------------------------- //
+
+// Parse the Flags following the positional Arguments into options.
+// Prints what is wrong and returns -1 if a Flag is unknown or invalid.
+int parse_options (int argc, char * argv[], struct Options * options) {
+
+    const char * value;
+    long number;
+
+    for (int iLauf = 5; iLauf < argc; iLauf ++) {
+        if ((value = option_value(argc, argv, &iLauf, "--rule")) != NULL) {
+            if (parse_rule(value, &options->rule) < 0) {
+                fprintf(stderr, "Invalid Rule \"%s\" (expected e.g. B3/S23)\n", value);
+                return -1;
+            }
+        } else if ((value = option_value(argc, argv, &iLauf, "--stats")) != NULL) {
+            options->stats_path = value;
+        } else if ((value = option_value(argc, argv, &iLauf, "--trace")) != NULL) {
+            if (parse_trace_categories(value, &options->trace) < 0) {
+                fprintf(stderr, "Invalid Trace Categories \"%s\"\n", value);
+                return -1;
+            }
+        } else if ((value = option_value(argc, argv, &iLauf, "--trace-file")) != NULL) {
+            options->trace_path = value;
+        } else if ((value = option_value(argc, argv, &iLauf, "--view")) != NULL) {
+            if (parse_render_mode(value, &options->view) < 0) {
+                fprintf(stderr, "Invalid View \"%s\" (expected cells, half or braille)\n", value);
+                return -1;
+            }
+        } else if ((value = option_value(argc, argv, &iLauf, "--render-fps")) != NULL) {
+            if (option_number(value, 0, 1000, &number) < 0) {
+                fprintf(stderr, "Invalid Frame Rate \"%s\" (expected 0 - 1000)\n", value);
+                return -1;
+            }
+            options->render_fps = number;
+        } else if ((value = option_value(argc, argv, &iLauf, "--fps")) != NULL) {
+            if (option_number(value, 1, 1000000, &number) < 0) {
+                fprintf(stderr, "Invalid Generation Rate \"%s\" (expected 1 - 1000000)\n", value);
+                return -1;
+            }
+            options->delay = 1000000000LL / number;
+        } else if ((value = option_value(argc, argv, &iLauf, "--delay-ms")) != NULL) {
+            if (option_number(value, 0, 3600000, &number) < 0) {
+                fprintf(stderr, "Invalid Delay \"%s\" (expected 0 - 3600000)\n", value);
+                return -1;
+            }
+            options->delay = number * 1000000LL;
+        } else if ((value = option_value(argc, argv, &iLauf, "--gif")) != NULL) {
+            options->gif_path = value;
+        } else if ((value = option_value(argc, argv, &iLauf, "--gif-scale")) != NULL) {
+            if (option_number(value, 1, 64, &number) < 0) {
+                fprintf(stderr, "Invalid GIF Scale \"%s\" (expected 1 - 64)\n", value);
+                return -1;
+            }
+            options->gif_scale = number;
+        } else if ((value = option_value(argc, argv, &iLauf, "--gif-delay")) != NULL) {
+            // The GIF stores the Delay in 1/100 s in 16 Bits
+            if (option_number(value, 0, 655350, &number) < 0) {
+                fprintf(stderr, "Invalid GIF Delay \"%s\" (expected 0 - 655350)\n", value);
+                return -1;
+            }
+            options->gif_delay = number;
+        } else if ((value = option_value(argc, argv, &iLauf, "--frames")) != NULL) {
+            options->frames_path = value;
+        } else if ((value = option_value(argc, argv, &iLauf, "--sparse")) != NULL) {
+            options->sparse_path = value;
+        } else if ((value = option_value(argc, argv, &iLauf, "--batch")) != NULL) {
+            options->batch_path = value;
+        } else if ((value = option_value(argc, argv, &iLauf, "--census")) != NULL) {
+            options->census_path = value;
+        } else if (strcmp(argv[iLauf], "--render-thread") == 0) {
+            options->render_thread = true;
+        } else {
+            fprintf(stderr, "Unknown Option \"%s\"\n", argv[iLauf]);
+            return -1;
+        }
+    }
+
+    return 0;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Get the Time between two Generations for the Pacer (in ns).
+// Without --fps or --delay-ms it is default_ms, unless the Frames are drawn
+// by the Render Thread (then the Generations are calculated without Delay).
+long long pace_interval (const struct Options * options, long default_ms) {
+    if (options->delay >= 0) return options->delay;
+    return options->render_thread ? 0 : default_ms * 1000000LL;
+}
+
+// -------------------------------------------------------------------------- //
+
+// Check if argv[*idx] is the Flag name and return its Value.
+// The Value is either appended using '=' or the next Argument, in which case
+// idx is moved past it.
+// Returns NULL if the Argument is a different Flag or the Value is missing.
+static const char * option_value (int argc, char * argv[], int * idx, const char * name) {
+
+    size_t len = strlen(name);
+    const char * arg = argv[*idx];
+
+    if (strncmp(arg, name, len) != 0) return NULL;
+    if (arg[len] == '=') return arg + len + 1;
+    if ((arg[len] != '\0') || ((*idx + 1) >= argc)) return NULL;
+
+    *idx += 1;
+    return argv[*idx];
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Convert the whole Value into a Number between min and max.
+// Returns -1 if it is not a Number or out of Range.
+static int option_number (const char * value, long min, long max, long * number) {
+    char * end;
+    *number = strtol(value, &end, 10);
+    if ((*value == '\0') || (*end != '\0') || (*number < min) || (*number > max)) return -1;
+    return 0;
+}
+
+// -------------------------------------------------------------------------- //
@@ -0,0 +1,73 @@
+
+// -------------------------------------------------------------------------- //
+// --- Explanation ---------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Pacing of the Generations, so they are shown at a steady Rate:
+//
+//      ./game 50 40 0.3 100 --fps 60           => 60 Generations per Second
+//      ./game 50 40 0.3 100 --delay-ms 250     => One Generation every 250 ms
+//
+// Instead of sleeping for the whole Delay after every Generation (which
+// makes every Interval as long as the Delay plus the Time it took to
+// calculate and draw the Generation), the Pacer sleeps until an absolute
+// Deadline using clock_nanosleep. The Deadline moves on by exactly one
+// Interval per Generation, so the Time spent calculating is compensated and
+// the Intervals stay the same even if some Generations take longer.
+// If a Generation missed its Deadline the Pacer does not try
+// to catch up with a Burst of Generations, but starts over from now.
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+#include <errno.h>
+
+struct Pacer {
+    // Time between two Generations in ns (0 => no Delay)
+    long long interval;
+    // Time the current Generation ends at
+    struct timespec deadline;
+};
+
+// -------------------------------------------------------------------------- //
+
+void init_pacer (struct Pacer * p, long long interval);
+void pace (struct Pacer * p);
+static long long pacer_ns (const struct timespec * t);
+
+// -------------------------------------------------------------------------- //
+
+// Start pacing from now on with the given Interval (in ns)
+void init_pacer (struct Pacer * p, long long interval) {
+    p->interval = interval;
+    clock_gettime(CLOCK_MONOTONIC, &p->deadline);
+}
+
+// Wait until the current Generation is over
+void pace (struct Pacer * p) {
+
+    if (p->interval <= 0) return;
+
+    long long deadline = pacer_ns(&p->deadline) + p->interval;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    // Past the Deadline => Start over instead of catching up
+    if (pacer_ns(&now) > deadline) {
+        p->deadline = now;
+        return;
+    }
+
+    p->deadline.tv_sec = deadline / 1000000000LL;
+    p->deadline.tv_nsec = deadline % 1000000000LL;
+    // Sleep again if a Signal woke the Thread up too early
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &p->deadline, NULL) == EINTR);
+
+}
+
+static long long pacer_ns (const struct timespec * t) {
+    return t->tv_sec * 1000000000LL + t->tv_nsec;
+}
+
+// -------------------------------------------------------------------------- //
@@ -0,0 +1,946 @@
+
+// -------------------------------------------------------------------------- //
+
+#define TRUE true
+#define FALSE false
+
+// Prints Output to .pbm Files
+#ifndef TO_FILE
+    #define TO_FILE TRUE
+#endif
+// Run in Debug-Mode => Waits for Input after every Round
+// This Option only has an Effect if TO_FILE is false
+#define DEBUG TRUE
+#if TO_FILE == TRUE
+    #undef DEBUG
+    #define DEBUG FALSE
+#endif
+
+// Delay between rounds (in ms) when the Game is displayed on the Terminal.
+// Can be changed using --delay-ms or --fps.
+#ifndef DELAY_MS
+    #define DELAY_MS 500
+#endif
+
+// Number of Generations calculated at once (Temporal Blocking, 1 = off)
+// Instead of streaming the whole Board through Memory once per Generation,
+// the Board is split into Bands of Rows. Each Band is copied (together with
+// TIME_BLOCK Rows above and below it) into a Buffer which fits into the Cache
+// and advanced TIME_BLOCK Generations there before it is written back.
+// With every Generation the valid Part of the Buffer shrinks by one Row on
+// each Side (a Trapezoid), so the extra Rows are calculated by both
+// neighbouring Bands. The Board is only displayed every TIME_BLOCK
+// Generations.
+#ifndef TIME_BLOCK
+    #define TIME_BLOCK 1
+#endif
+// Size of the Cache both Buffers of a Thread should fit into
+// (determines the Height of the Bands)
+#ifndef BLOCK_CACHE_SIZE
+    #define BLOCK_CACHE_SIZE (1 << 20)
+#endif
+
+// Number of Threads calculating a Generation (0 = one per online CPU)
+#ifndef THREADS
+    #define THREADS 0
+#endif
+
+// Because of all the Options sometimes the Compiler would complain
+// about unused Parameters which would be needed for other Options.
+// This Macro is a No-OP but suppresses the Unused Warning.
+#define UNUSED(x) (void)(x)
+
+// -------------------------------------------------------------------------- //
+
+#include "options.c"
+#include "profile.c"
+#include "scheduler.c"
+#include "stats.c"
+#include "bitmap.c"
+#include "bitslice.c"
+#include "census.c"
+#include "batch.c"
+
+// The Kernels work on whole Words, so a Tile must not split one.
+_Static_assert((TILE_WIDTH % 64) == 0, "TILE_WIDTH has to be a Multiple of 64");
+
+// Arguments for step_tile, which is called by the Scheduler
+struct StepContext {
+    struct Bitmap * src;
+    struct Bitmap * dest;
+    struct Kernel kernel;
+    // Number of Generations calculated by step_band
+    int generations;
+};
+
+struct Scheduler scheduler;
+
+// Statistics of every Generation (only used with --stats)
+struct StatsStream stats_stream;
+
+// Frames shown on the Terminal (only used if TO_FILE is FALSE)
+struct Renderer renderer;
+// Draws the Frames with --render-thread
+struct RenderThread render_thread;
+
+// Animated GIF of the Generations (only used with --gif)
+struct GifWriter gif;
+// Compressed Stream of the Generations (only used with --frames)
+struct FrameStream frame_stream;
+
+// Buffers for the Temporal Blocking (2 per Thread of the Scheduler)
+struct Bitmap * band_buffers;
+
+// -------------------------------------------------------------------------- //
+
+int game_of_life(int argc, char* argv[]);
+int init (struct Bitmap boards[2], int width, int height, double density);
+void uninit (struct Bitmap boards[2]);
+int main_loop (struct Bitmap boards[2], int steps);
+void step_tile (void * ctx, struct Tile tile);
+int band_height (int width, int height);
+int init_band_buffers (int threads, int width, int rows);
+void uninit_band_buffers (int threads);
+void step_band (void * ctx, struct Tile tile);
+int print_cells_to_file(const struct Bitmap * cells, int iStep);
+int print_cells(const struct Bitmap * cells, int round, bool last);
+
+// -------------------------------------------------------------------------- //
+
+// TEST is set/defined via the Command Line using <gcc game.c -DTEST>
+#ifndef TEST
+
+    int game_of_life(int argc, char* argv[]) {
+        if(argc < 5) {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        if (parse_options(argc, argv, &options) < 0) {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        // The Board has Bounds, so all its Cells fit into --frames
+        if (options.sparse_path != NULL) {
+            printf("--sparse is only supported by the Complicated Variant\n");
+            return EXIT_FAILURE;
+        }
+        if (start_trace(options.trace, options.trace_path) < 0) {
+            printf("Could not start the Trace\n");
+            return EXIT_FAILURE;
+        }
+
+        const int width = atoi(argv[1]);
+        const int height = atoi(argv[2]);
+        const double density = atof(argv[3]);
+        const int steps = atoi(argv[4]);
+
+        if ((options.census_path != NULL) && (options.batch_path == NULL)) {
+            printf("--census needs --batch\n");
+            stop_trace();
+            return EXIT_FAILURE;
+        }
+        // Play the Boards of the Batch File instead of a single Game
+        if (options.batch_path != NULL) {
+            if (
+                (options.stats_path != NULL) || (options.gif_path != NULL) ||
+                (options.frames_path != NULL) || options.render_thread
+            ) {
+                printf("--stats, --gif, --frames and --render-thread are not supported with --batch\n");
+                stop_trace();
+                return EXIT_FAILURE;
+            }
+            int result = run_batch(options.batch_path, width, height, density, steps);
+            stop_trace();
+            return (result < 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+        }
+
+        // Seeding the random number generator so we get a different starting field
+        // every time.
+        srand(time(NULL));
+
+        // Allocate both Boards
+        struct Bitmap boards[2];
+        if (init(boards, width, height, density) < 0) {
+            printf("Could not allocate a Board of %d x %d Cells\n", width, height);
+            stop_trace();
+            return EXIT_FAILURE;
+        }
+
+        // Start the Threads calculating the Generations
+        #if TIME_BLOCK > 1
+            // Every Tile is a Band of whole Rows
+            const int band = band_height(width, height);
+            int error = init_scheduler_tiles(&scheduler, THREADS, width, height, width, band);
+            if ((error == 0) && (init_band_buffers(scheduler.num_threads, width, band) < 0)) {
+                uninit_scheduler(&scheduler);
+                error = -1;
+            }
+        #else
+            int error = init_scheduler(&scheduler, THREADS, width, height);
+        #endif
+        if (error < 0) {
+            printf("Could not start the Scheduler\n");
+            uninit(boards);
+            stop_trace();
+            return EXIT_FAILURE;
+        }
+
+        if (
+            (options.stats_path != NULL) &&
+            (open_stats(&stats_stream, options.stats_path, scheduler.num_threads) < 0)
+        ) {
+            printf("Could not open the Statistics File \"%s\"\n", options.stats_path);
+            #if TIME_BLOCK > 1
+                uninit_band_buffers(scheduler.num_threads);
+            #endif
+            uninit_scheduler(&scheduler);
+            uninit(boards);
+            stop_trace();
+            return EXIT_FAILURE;
+        }
+
+        if (
+            (options.gif_path != NULL) &&
+            (open_gif(&gif, options.gif_path, width, height, options.gif_scale, options.gif_delay) < 0)
+        ) {
+            printf("Could not create the GIF \"%s\"\n", options.gif_path);
+            close_stats(&stats_stream);
+            #if TIME_BLOCK > 1
+                uninit_band_buffers(scheduler.num_threads);
+            #endif
+            uninit_scheduler(&scheduler);
+            uninit(boards);
+            stop_trace();
+            return EXIT_FAILURE;
+        }
+
+        if (
+            (options.frames_path != NULL) &&
+            (open_frame_stream(&frame_stream, options.frames_path, width, height) < 0)
+        ) {
+            printf("Could not create the Frame Stream \"%s\"\n", options.frames_path);
+            close_gif(&gif);
+            close_stats(&stats_stream);
+            #if TIME_BLOCK > 1
+                uninit_band_buffers(scheduler.num_threads);
+            #endif
+            uninit_scheduler(&scheduler);
+            uninit(boards);
+            stop_trace();
+            return EXIT_FAILURE;
+        }
+
+        #if TO_FILE == FALSE
+            if (init_renderer(&renderer, options.view, width, height, options.render_fps) < 0) {
+                printf("Could not allocate the Frames for the Terminal\n");
+                close_frame_stream(&frame_stream);
+                close_gif(&gif);
+                close_stats(&stats_stream);
+                #if TIME_BLOCK > 1
+                    uninit_band_buffers(scheduler.num_threads);
+                #endif
+                uninit_scheduler(&scheduler);
+                uninit(boards);
+                stop_trace();
+                return EXIT_FAILURE;
+            }
+            if (options.render_thread && (start_render_thread(&render_thread, &renderer) < 0)) {
+                printf("Could not start the Render Thread\n");
+                uninit_renderer(&renderer);
+                close_frame_stream(&frame_stream);
+                close_gif(&gif);
+                close_stats(&stats_stream);
+                #if TIME_BLOCK > 1
+                    uninit_band_buffers(scheduler.num_threads);
+                #endif
+                uninit_scheduler(&scheduler);
+                uninit(boards);
+                stop_trace();
+                return EXIT_FAILURE;
+            }
+        #endif
+
+        // Get temporary Screen, saving the current Terminal Output and hide the
+        // Cursor
+        printf("\x1B[?1049h\x1B[?25l");
+
+        // Loop for the Amount specified in Steps
+        int result = main_loop(boards, steps);
+
+        #if TO_FILE == FALSE
+            // Draw the last Snapshot before the Terminal is restored
+            if (options.render_thread && (stop_render_thread(&render_thread) < 0)) result = -1;
+        #endif
+
+        // Restore Terminal Output and show the cursor again
+        printf("\x1B[?1049l\x1B[?25h");
+
+        if (close_frame_stream(&frame_stream) < 0) {
+            printf("Could not write the Frame Stream \"%s\"\n", options.frames_path);
+            result = -1;
+        }
+        if (close_gif(&gif) < 0) {
+            printf("Could not write the GIF \"%s\"\n", options.gif_path);
+            result = -1;
+        }
+        close_stats(&stats_stream);
+        #if TO_FILE == FALSE
+            uninit_renderer(&renderer);
+        #endif
+        #if TIME_BLOCK > 1
+            uninit_band_buffers(scheduler.num_threads);
+        #endif
+        uninit_scheduler(&scheduler);
+        uninit(boards);
+        stop_trace();
+
+        return (result < 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+#else
+
+    int test_batch_lanes ();
+    int test_frames ();
+    void read_test_frame (void * ctx, struct Tile tile);
+
+    // Frames decoded by the Threads of test_frames
+    struct FrameCheck {
+        const struct FrameReader * reader;
+        uint64_t * cells;
+        long * generations;
+        int * results;
+    };
+
+    // Compare the specialised Kernels (with and without Statistics) with the
+    // generic Kernel using the same Masks on random Soups, for odd and even
+    // Sizes and both Topologies.
+    int game_of_life(int argc, char* argv[]) {
+
+        UNUSED(argc);
+        UNUSED(argv);
+
+        struct KernelCase {
+            const char * name;
+            uint16_t birth;
+            uint16_t survive;
+            BitsliceKernel kernel;
+            BitsliceKernel kernel_stats;
+        };
+        const struct KernelCase kernels[] = {
+            #define KERNEL_CASE(name, B, S) {#name, B, S, step_##name, step_##name##_stats},
+            SPECIALISED_RULES(KERNEL_CASE)
+            #undef KERNEL_CASE
+        };
+        const int sizes[][2] = {{200, 100}, {203, 101}, {64, 7}, {1, 1}};
+        const char * topologies[] = {"Dead Edges", "Torus"};
+        const int steps = 20;
+        int errors = 0;
+
+        // boards[0] is the current Generation, boards[1] the one of the
+        // generic Kernel and boards[2 - 4] the ones of the Kernels it is
+        // compared with
+        struct Bitmap boards[5];
+        for (int iLauf = 0; iLauf < 5; iLauf ++) {
+            if (init_bitmap(&boards[iLauf], 1, 1) < 0) {
+                for (; iLauf > 0; iLauf --) uninit_bitmap(&boards[iLauf-1]);
+                printf("Could not allocate the Boards\n");
+                return EXIT_FAILURE;
+            }
+        }
+
+        for (unsigned iKernel = 0; iKernel < (sizeof(kernels) / sizeof(kernels[0])); iKernel ++) {
+            const struct KernelCase * k = &kernels[iKernel];
+            const uint16_t birth = k->birth;
+            const uint16_t survive = k->survive;
+
+            for (unsigned iSize = 0; iSize < (sizeof(sizes) / sizeof(sizes[0])); iSize ++) {
+                for (int iTopology = 0; iTopology < 2; iTopology ++) {
+                    const int width = sizes[iSize][0];
+                    const int height = sizes[iSize][1];
+
+                    // Reshaping kills all Cells, including the Ghost Cells
+                    for (int iLauf = 0; iLauf < 5; iLauf ++) {
+                        if (reshape_bitmap(&boards[iLauf], width, height) < 0) {
+                            for (int iLauf2 = 0; iLauf2 < 5; iLauf2 ++) uninit_bitmap(&boards[iLauf2]);
+                            printf("Could not allocate the Boards\n");
+                            return EXIT_FAILURE;
+                        }
+                    }
+                    fill_bitmap(&boards[0], 0.35, iKernel * 100 + iSize);
+
+                    struct Bitmap * src = &boards[0];
+                    struct Bitmap * expected = &boards[1];
+                    struct Stats stats, expected_stats;
+                    long mismatches = 0;
+
+                    for (int iStep = 0; iStep < steps; iStep ++) {
+                        if (iTopology == 1) wrap_bitmap_halo(src);
+                        const long words = src->words;
+
+                        step_generic(src, expected, 0, height, 0, words, birth, survive, NULL);
+                        k->kernel(src, &boards[2], 0, height, 0, words, birth, survive, NULL);
+                        reset_stats(&stats);
+                        reset_stats(&expected_stats);
+                        k->kernel_stats(src, &boards[3], 0, height, 0, words, birth, survive, &stats);
+                        step_generic_stats(src, &boards[4], 0, height, 0, words, birth, survive, &expected_stats);
+
+                        for (long iLauf = 0; iLauf < height; iLauf ++) {
+                            const size_t size = sizeof(u64) * words;
+                            if (
+                                (memcmp(bitmap_row(&boards[2], iLauf), bitmap_row(expected, iLauf), size) != 0) ||
+                                (memcmp(bitmap_row(&boards[3], iLauf), bitmap_row(expected, iLauf), size) != 0) ||
+                                (memcmp(bitmap_row(&boards[4], iLauf), bitmap_row(expected, iLauf), size) != 0)
+                            ) {
+                                mismatches ++;
+                            }
+                        }
+                        if (memcmp(&stats, &expected_stats, sizeof(struct Stats)) != 0) mismatches ++;
+
+                        struct Bitmap * temp = src;
+                        src = expected;
+                        expected = temp;
+                    }
+
+                    printf(
+                        "\t%-10s %4d x %4d %-10s: %s\n", k->name, width, height, topologies[iTopology],
+                        mismatches ? "\x1B[31mFAILED\x1B[0m" : "\x1B[32mOK\x1B[0m"
+                    );
+                    if (mismatches) errors ++;
+                }
+            }
+        }
+
+        for (int iLauf = 0; iLauf < 5; iLauf ++) uninit_bitmap(&boards[iLauf]);
+
+        errors += test_batch_lanes();
+        errors += test_frames();
+
+        return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+
+    }
+
+// -------------------------------------------------------------------------- //
+
+    // Play the same Boards of a Batch in Lanes and one by one and compare
+    // their Results. Some Boards have fewer Steps than the others and some
+    // settle early, so their Lanes retire while the other ones go on.
+    // Returns the Number of failed Cases.
+    int test_batch_lanes () {
+
+        const char * rules[] = {"B3/S23", "B36/S23", "B2/S"};
+        const int sizes[][2] = {{16, 16}, {7, 30}};
+        int errors = 0;
+
+        struct BatchBoard lanes[LANES];
+        struct BatchBoard boards[LANES];
+        struct BatchBoard * order[LANES];
+        struct BatchBuffers buffers;
+        memset(&buffers, 0, sizeof(struct BatchBuffers));
+
+        for (unsigned iRule = 0; iRule < (sizeof(rules) / sizeof(rules[0])); iRule ++) {
+            struct Rule rule;
+            parse_rule(rules[iRule], &rule);
+            struct Batch batch = {
+                .kernel = select_kernel(&rule, false),
+                .census = false
+            };
+
+            for (unsigned iSize = 0; iSize < (sizeof(sizes) / sizeof(sizes[0])); iSize ++) {
+                for (int iLauf = 0; iLauf < LANES; iLauf ++) {
+                    struct BatchBoard b = {
+                        .seed = iLauf * 7919 + iSize,
+                        .width = sizes[iSize][0],
+                        .height = sizes[iSize][1],
+                        .density = 0.05 + 0.1 * (iLauf % 8),
+                        .steps = (iLauf % 5) ? 300 : iLauf
+                    };
+                    lanes[iLauf] = b;
+                    boards[iLauf] = b;
+                    order[iLauf] = &lanes[iLauf];
+                }
+                struct BatchGroup g = {.boards = order, .count = LANES, .lanes = true};
+                play_batch_lanes(&batch, &buffers, &g);
+
+                long mismatches = 0;
+                for (int iLauf = 0; iLauf < LANES; iLauf ++) {
+                    play_batch_board(&batch, &buffers, &boards[iLauf]);
+                    if (
+                        (lanes[iLauf].error != boards[iLauf].error) ||
+                        (lanes[iLauf].generations != boards[iLauf].generations) ||
+                        (lanes[iLauf].population != boards[iLauf].population) ||
+                        (lanes[iLauf].period != boards[iLauf].period)
+                    ) {
+                        mismatches ++;
+                    }
+                }
+
+                printf(
+                    "\tLanes %-8s %4d x %4d: %s\n", rules[iRule], sizes[iSize][0], sizes[iSize][1],
+                    mismatches ? "\x1B[31mFAILED\x1B[0m" : "\x1B[32mOK\x1B[0m"
+                );
+                if (mismatches) errors ++;
+            }
+        }
+
+        for (int iLauf = 0; iLauf < 3; iLauf ++) uninit_bitmap(&buffers.bitmaps[iLauf]);
+        free(buffers.lanes);
+        uninit_census(&buffers.census);
+
+        return errors;
+
+    }
+
+// -------------------------------------------------------------------------- //
+
+    // Write some Generations (and an empty Board) into a Frame Stream, decode
+    // all Frames at once on the Threads of a Scheduler, from the last to the
+    // first, and compare them with the Boards.
+    // Returns 1 if the Test failed.
+    int test_frames () {
+
+        const char * path = "test_frames.golf";
+        const int width = 203, height = 101, frames = 16;
+        const long size = ((width + 63) / 64) * height;
+        int errors = 0;
+
+        struct Bitmap boards[2];
+        struct FrameStream stream;
+        uint64_t * expected = calloc(size * frames, sizeof(uint64_t));
+        struct FrameCheck check = {
+            .cells = calloc(size * frames, sizeof(uint64_t)),
+            .generations = calloc(frames, sizeof(long)),
+            .results = calloc(frames, sizeof(int))
+        };
+        if (
+            (expected == NULL) || (check.cells == NULL) || (check.generations == NULL) ||
+            (check.results == NULL) || (init_bitmap(&boards[0], width, height) < 0)
+        ) {
+            free(expected);
+            free(check.cells);
+            free(check.generations);
+            free(check.results);
+            return 1;
+        }
+        if (init_bitmap(&boards[1], width, height) < 0) {
+            uninit_bitmap(&boards[0]);
+            free(expected);
+            free(check.cells);
+            free(check.generations);
+            free(check.results);
+            return 1;
+        }
+        if (open_frame_stream(&stream, path, width, height) < 0) errors = 1;
+
+        // The Frames hold the Generations 0, 3, 6, ... and an empty Board
+        parse_rule("B3/S23", &options.rule);
+        struct Kernel kernel = select_kernel(&options.rule, false);
+        fill_bitmap(&boards[0], 0.3, 7);
+        int curr = 0;
+        for (int iLauf = 0; (errors == 0) && (iLauf < frames); iLauf ++) {
+            if (iLauf == (frames - 1)) {
+                memset(boards[curr].memory, 0, sizeof(u64) * boards[curr].capacity);
+            }
+            for (long iLauf2 = 0; iLauf2 < height; iLauf2 ++) {
+                u64 * row = expected + iLauf * size + iLauf2 * boards[curr].words;
+                memcpy(row, bitmap_row(&boards[curr], iLauf2), sizeof(u64) * boards[curr].words);
+                row[boards[curr].words - 1] &= boards[curr].tail_mask;
+            }
+            if (write_frame(&stream, bitmap_row(&boards[curr], 0), boards[curr].stride, 3 * iLauf) < 0) {
+                errors = 1;
+            }
+            for (int iLauf2 = 0; iLauf2 < 3; iLauf2 ++) {
+                exchange_bitmap_halo(&boards[curr]);
+                run_kernel(&kernel, &boards[curr], &boards[1 - curr], 0, height, 0, boards[curr].words, NULL);
+                curr = 1 - curr;
+            }
+        }
+        if (close_frame_stream(&stream) < 0) errors = 1;
+
+        // Decode every Frame as its own Tile
+        struct FrameReader reader;
+        struct Scheduler pool;
+        if ((errors == 0) && (open_frame_reader(&reader, path) == 0)) {
+            check.reader = &reader;
+            if (
+                (reader.width != width) || (reader.height != height) || (reader.frames != frames) ||
+                (init_scheduler_tiles(&pool, 4, frames, 1, 1, 1) < 0)
+            ) {
+                errors = 1;
+            } else {
+                run_tiles(&pool, read_test_frame, &check);
+                uninit_scheduler(&pool);
+                for (int iLauf = 0; iLauf < frames; iLauf ++) {
+                    if (
+                        (check.results[iLauf] != 0) || (check.generations[iLauf] != 3 * iLauf) ||
+                        (memcmp(check.cells + iLauf * size, expected + iLauf * size, sizeof(u64) * size) != 0)
+                    ) {
+                        errors = 1;
+                    }
+                }
+            }
+            close_frame_reader(&reader);
+        } else {
+            errors = 1;
+        }
+
+        printf(
+            "\tFrames   %4d x %4d: %s\n", width, height,
+            errors ? "\x1B[31mFAILED\x1B[0m" : "\x1B[32mOK\x1B[0m"
+        );
+
+        remove(path);
+        uninit_bitmap(&boards[0]);
+        uninit_bitmap(&boards[1]);
+        free(expected);
+        free(check.cells);
+        free(check.generations);
+        free(check.results);
+
+        return errors;
+
+    }
+
+    // Decode one Frame (called by the Scheduler), starting with the last one
+    void read_test_frame (void * ctx, struct Tile tile) {
+        struct FrameCheck * check = ctx;
+        const long index = check->reader->frames - 1 - tile.x_begin;
+        const long size = check->reader->words * check->reader->height;
+        check->results[index] = read_frame(
+            check->reader, index, check->cells + index * size, &check->generations[index]
+        );
+    }
+
+#endif
+
+// -------------------------------------------------------------------------- //
+
+// Allocate both Boards and fill the first one randomly.
+// Returns -1 if the Boards could not be allocated.
+int init (struct Bitmap boards[2], int width, int height, double density) {
+
+    if (init_bitmap(&boards[0], width, height) < 0) return -1;
+    if (init_bitmap(&boards[1], width, height) < 0) {
+        uninit_bitmap(&boards[0]);
+        return -1;
+    }
+
+    // Multiply the Density by the maximum number that rand() can return
+    int i_density = RAND_MAX * density;
+
+    for (long iLauf = 0; iLauf < height; iLauf ++) {
+        for (long iLauf2 = 0; iLauf2 < width; iLauf2 ++) {
+            set_bit(&boards[0], iLauf2, iLauf, rand() <= i_density);
+        }
+    }
+
+    return 0;
+
+}
+
+void uninit (struct Bitmap boards[2]) {
+    uninit_bitmap(&boards[0]);
+    uninit_bitmap(&boards[1]);
+}
+
+// -------------------------------------------------------------------------- //
+
+// Loop for the specified amount of Steps
+//      1. Display the Board
+//      2. Fill the Ghost Cells
+//      3. Calculate the next Generation using the Kernel of the Rule
+//         (or the next TIME_BLOCK Generations if Temporal Blocking is used)
+//      4. Write the Statistics of the new Generation (with --stats)
+//      5. Wait for the next Generation (--fps, --delay-ms)
+// Returns -1 if the Board or the Statistics could not be written to a File.
+int main_loop (struct Bitmap boards[2], int steps) {
+
+    struct StepContext ctx = {
+        .src = &boards[0],
+        .dest = &boards[1],
+        .kernel = select_kernel(&options.rule, stats_stream.file != NULL),
+        .generations = 1
+    };
+    struct Bitmap * temp;
+    PROFILE_TIMER(output);
+    PROFILE_TIMER(compute);
+
+    // Pace the Generations (only if they are shown on the Terminal, unless
+    // a Rate was given)
+    struct Pacer pacer;
+    #if TO_FILE == TRUE
+        init_pacer(&pacer, pace_interval(&options, 0));
+    #else
+        init_pacer(&pacer, pace_interval(&options, DELAY_MS));
+    #endif
+
+    for (int iStep = 0; iStep < steps; iStep += ctx.generations) {
+        // Display the Board (either in a File or on the Terminal)
+        PROFILE_START(output);
+        #if TO_FILE == TRUE
+            // With --gif or --frames the Generations only go there
+            if (
+                (gif.file == NULL) && (frame_stream.file == NULL) &&
+                (print_cells_to_file(ctx.src, iStep) < 0)
+            ) {
+                return -1;
+            }
+        #else
+            if (print_cells(ctx.src, iStep + 1, (iStep + TIME_BLOCK) >= steps) < 0) return -1;
+        #endif
+        // The Board is packed already, so it goes straight into the GIF and
+        // the Frame Stream
+        if ((gif.file != NULL) && (write_gif_frame(&gif, bitmap_row(ctx.src, 0), ctx.src->stride) < 0)) {
+            return -1;
+        }
+        if (
+            (frame_stream.file != NULL) &&
+            (write_frame(&frame_stream, bitmap_row(ctx.src, 0), ctx.src->stride, iStep) < 0)
+        ) {
+            return -1;
+        }
+        PROFILE_STOP(output);
+        PROFILE_START(compute);
+        #if TIME_BLOCK > 1
+            // Calculate the next Generations Band by Band
+            ctx.generations = TIME_BLOCK;
+            if (ctx.generations > (steps - iStep)) ctx.generations = steps - iStep;
+            run_tiles(&scheduler, step_band, &ctx);
+        #else
+            // Calculate the next Generation Tile by Tile
+            exchange_bitmap_halo(ctx.src);
+            run_tiles(&scheduler, step_tile, &ctx);
+        #endif
+        PROFILE_STOP(compute);
+        PROFILE_START(output);
+        if (
+            (stats_stream.file != NULL) &&
+            (write_stats(&stats_stream, iStep + ctx.generations) < 0)
+        ) {
+            return -1;
+        }
+        PROFILE_STOP(output);
+        PROFILE_FLUSH(output);
+        PROFILE_FLUSH(compute);
+        PROFILE_GENERATION();
+        #if DEBUG == TRUE
+            // Wait for Enter, unless a Rate was given or the Frames are drawn
+            // by the Render Thread
+            if ((options.delay < 0) && !options.render_thread) {
+                getchar();
+            } else {
+                pace(&pacer);
+            }
+        #else
+            pace(&pacer);
+        #endif
+        // Swap the Boards
+        temp = ctx.src;
+        ctx.src = ctx.dest;
+        ctx.dest = temp;
+    }
+
+    return 0;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Calculate the next Generation of all Cells inside the Tile
+void step_tile (void * arg, struct Tile tile) {
+    struct StepContext * ctx = arg;
+    struct Stats tile_stats;
+    reset_stats(&tile_stats);
+    run_kernel(
+        &ctx->kernel, ctx->src, ctx->dest, tile.y_begin, tile.y_end,
+        tile.x_begin / 64, (tile.x_end + 63) / 64, &tile_stats
+    );
+    if (stats_stream.file != NULL) {
+        add_tile_stats(&stats_stream.slots[scheduler_thread_index()], &tile_stats);
+    }
+}
+
+// -------------------------------------------------------------------------- //
+
+// Number of Rows per Band, so that both Buffers of a Thread (each holding a
+// Band plus TIME_BLOCK Rows on each Side) fit into BLOCK_CACHE_SIZE.
+// The Bands are at least 2 * TIME_BLOCK Rows high, otherwise more than half
+// of the Work would be spent on the overlapping Rows.
+int band_height (int width, int height) {
+    long row_bytes = sizeof(u64) * ((width + 63) / 64 + 2);
+    long rows = BLOCK_CACHE_SIZE / (2 * row_bytes) - 2 * TIME_BLOCK;
+    if (rows < (2 * TIME_BLOCK)) rows = 2 * TIME_BLOCK;
+    if (rows > height) rows = height;
+    return rows;
+}
+
+// Allocate 2 Buffers for every Thread, which can hold a Band and the
+// overlapping Rows.
+// Returns -1 if not enough Memory could be allocated.
+int init_band_buffers (int threads, int width, int rows) {
+    band_buffers = calloc(2 * threads, sizeof(struct Bitmap));
+    if (band_buffers == NULL) return -1;
+    for (int iLauf = 0; iLauf < (2 * threads); iLauf ++) {
+        if (init_bitmap(&band_buffers[iLauf], width, rows + 2 * TIME_BLOCK) < 0) {
+            uninit_band_buffers(threads);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void uninit_band_buffers (int threads) {
+    if (band_buffers == NULL) return;
+    // uninit_bitmap ignores Buffers which were never allocated
+    for (int iLauf = 0; iLauf < (2 * threads); iLauf ++) {
+        uninit_bitmap(&band_buffers[iLauf]);
+    }
+    free(band_buffers);
+    band_buffers = NULL;
+}
+
+// Calculate the next ctx->generations Generations of the Band of Rows
+// [tile.y_begin, tile.y_end) inside the Buffers of the calling Thread.
+// Row i of the Buffers holds Row (tile.y_begin - generations + i) of the
+// Board.
+// Only the last Generation is counted for the Statistics, since the Rows it
+// calculates are exactly the Rows of the Band.
+void step_band (void * arg, struct Tile tile) {
+
+    struct StepContext * ctx = arg;
+    const struct Bitmap * board = ctx->src;
+    const int gens = ctx->generations;
+    const long first = tile.y_begin - gens;
+    const long rows = (tile.y_end - tile.y_begin) + 2 * gens;
+    const size_t row_size = sizeof(u64) * board->words;
+
+    struct Bitmap * a = &band_buffers[2 * scheduler_thread_index()];
+    struct Bitmap * b = a + 1;
+    struct Bitmap * temp;
+    struct Stats tile_stats;
+    reset_stats(&tile_stats);
+
+    // Copy the Band and the Rows around it into the Buffer
+    for (long iLauf = 0; iLauf < rows; iLauf ++) {
+        long y = first + iLauf;
+        #if TOPOLOGY == TORUS
+            y = ((y % board->height) + board->height) % board->height;
+            memcpy(bitmap_row(a, iLauf), bitmap_row(board, y), row_size);
+        #else
+            // Rows outside of the Board are dead and never calculated
+            if ((y < 0) || (y >= board->height)) {
+                memset(bitmap_row(a, iLauf), 0, row_size);
+                memset(bitmap_row(b, iLauf), 0, row_size);
+            } else {
+                memcpy(bitmap_row(a, iLauf), bitmap_row(board, y), row_size);
+            }
+        #endif
+    }
+
+    // Every Generation the Rows at the Border of the Buffer become invalid,
+    // since their Neighbours were not calculated.
+    for (int iLauf = 1; iLauf <= gens; iLauf ++) {
+        long y_begin = iLauf;
+        long y_end = rows - iLauf;
+        #if TOPOLOGY == TORUS
+            for (long iLauf2 = y_begin - 1; iLauf2 <= y_end; iLauf2 ++) {
+                wrap_bitmap_row(a, iLauf2);
+            }
+        #else
+            if (y_begin < -first) y_begin = -first;
+            if (y_end > (board->height - first)) y_end = board->height - first;
+        #endif
+        run_kernel(&ctx->kernel, a, b, y_begin, y_end, 0, board->words, (iLauf == gens) ? &tile_stats : NULL);
+        temp = a;
+        a = b;
+        b = temp;
+    }
+
+    // Write the Band back
+    for (long iLauf = tile.y_begin; iLauf < tile.y_end; iLauf ++) {
+        memcpy(bitmap_row(ctx->dest, iLauf), bitmap_row(a, iLauf - first), row_size);
+    }
+
+    if (stats_stream.file != NULL) {
+        shift_stats(&tile_stats, 0, first);
+        add_tile_stats(&stats_stream.slots[scheduler_thread_index()], &tile_stats);
+    }
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Print the Board to a .pbm-File named "build/gol_<iStep>.pbm" in the
+// Plain PBM-Format (see: http://netpbm.sourceforge.net/doc/pbm.html)
+// Returns -1 if the File could not be written.
+int print_cells_to_file(const struct Bitmap * cells, int iStep) {
+
+    char file_name[32];
+    snprintf(file_name, sizeof(file_name), "build/gol_%05d.pbm", iStep);
+
+    FILE * fd = fopen(file_name, "w");
+    if (!fd) {
+        printf("Could not open Files!\nEnsure that the Files are not already \
+                open in another File\n");
+        return -1;
+    }
+
+    // One Row of the Image plus the Newline
+    char * buffer = malloc(cells->width + 1);
+    if (!buffer) {
+        fclose(fd);
+        return -1;
+    }
+
+    // => P1\n<Width> <Height>\n
+    fprintf(fd, "P1\n%d %d\n", cells->width, cells->height);
+
+    // Write a '0' (white) for every alive Cell and a '1' (black) for every
+    // dead one.
+    for (long iLauf = 0; iLauf < cells->height; iLauf ++) {
+        for (long iLauf2 = 0; iLauf2 < cells->width; iLauf2 ++) {
+            buffer[iLauf2] = get_bit(cells, iLauf2, iLauf) ? '0' : '1';
+        }
+        buffer[cells->width] = '\n';
+        fwrite(buffer, sizeof(char), cells->width + 1, fd);
+    }
+
+    free(buffer);
+    fclose(fd);
+
+    return 0;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Show the Board on the Terminal using colors.
+// Only the Cells which changed since the last Round are redrawn.
+// With --render-thread the Board is only handed to the Render Thread (if it
+// wants a new Frame, or for the last Round).
+// Returns -1 if the Terminal could not be written to.
+int print_cells(const struct Bitmap * cells, int round, bool last) {
+
+    if (options.render_thread) {
+        uint64_t * bits = render_snapshot(&render_thread, last);
+        if (bits == NULL) return 0;
+        // Copy the Rows without their Padding
+        for (long iLauf = 0; iLauf < cells->height; iLauf ++) {
+            memcpy(
+                bits + iLauf * renderer.words, bitmap_row(cells, iLauf),
+                sizeof(uint64_t) * renderer.words
+            );
+        }
+        publish_snapshot(&render_thread, round);
+        return 0;
+    }
+
+    // Skip the Frame if its Time has not come yet (--render-fps)
+    if (!render_due(&renderer)) return 0;
+
+    // The Board is packed already, so every View is made straight from it
+    render_rows(&renderer, bitmap_row(cells, 0), cells->stride);
+
+    return render_frame(&renderer, round);
+}
+
+// -------------------------------------------------------------------------- //
@@ -0,0 +1,215 @@
+
+// -------------------------------------------------------------------------- //
+// --- Explanation ---------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Timers for the Phases of a Generation and Counters for interesting Events,
+// which are only compiled in if PROFILE is TRUE (e.g. using -DPROFILE=TRUE).
+// Otherwise all Macros below are No-OPs and cost nothing.
+//
+// A Function measuring a Phase (possibly many Times, e.g. once per Cell)
+// sums up the Time in a local Variable and only adds it to the global
+// Accumulator once at the End, so the Timers can also be used by several
+// Threads at once without slowing each other down:
+//
+//      PROFILE_TIMER(compare);             => Declare the local Timer
+//      PROFILE_START(compare);             => Start measuring
+//      ...
+//      PROFILE_STOP(compare);              => Add the Time since the Start
+//      PROFILE_FLUSH(compare);             => Move the local Time to the Phase
+//
+//      PROFILE_COUNT(chunks, 1);           => Add to a Counter
+//      PROFILE_GENERATION();               => End of a Generation
+//      PROFILE_REPORT();                   => Print the Summary to STDERR
+//
+// At the End of every Generation the Time of each Phase goes into a
+// Histogram (with Buckets of Powers of 2), so the Summary shows how the
+// Time per Generation is distributed and not only the Average.
+// The Timers use the monotonic Clock (through the vDSO this only takes a few
+// Nanoseconds). Phases measured on several Threads show the summed up Time
+// of all Threads.
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+#define TRUE true
+#define FALSE false
+
+#ifndef PROFILE
+    #define PROFILE FALSE
+#endif
+
+// Phases which can be measured
+// PHASE(Name, Description)
+#define PROFILE_PHASES(PHASE) \
+    PHASE(compare,   "Neighbour Comparison") \
+    PHASE(temp,      "Temp-Cell Creation") \
+    PHASE(survive,   "Survival Pass") \
+    PHASE(resurrect, "Resurrection Pass") \
+    PHASE(reset,     "Terminal Reset") \
+    PHASE(compute,   "Compute") \
+    PHASE(output,    "Output")
+
+// Events which can be counted
+// COUNTER(Name, Description)
+#define PROFILE_COUNTERS(COUNTER) \
+    COUNTER(comparisons, "Comparisons") \
+    COUNTER(temp_cells,  "Temp-Cells created") \
+    COUNTER(chunks,      "Chunks allocated")
+
+#if PROFILE == TRUE
+
+    #include <stdatomic.h>
+
+    #define PROFILE_ENUM(name, description) PROFILE_##name,
+    enum ProfilePhase {PROFILE_PHASES(PROFILE_ENUM) NUM_PROFILE_PHASES};
+    enum ProfileCounter {PROFILE_COUNTERS(PROFILE_ENUM) NUM_PROFILE_COUNTERS};
+    #undef PROFILE_ENUM
+
+    // Number of Buckets of the Histograms (Bucket i = [2^i, 2^(i+1)) ns)
+    #define PROFILE_BUCKETS 40
+
+    struct ProfilePhaseStats {
+        // Time of the current Generation
+        _Atomic long long generation;
+        long long total;
+        long long max;
+        long samples;
+        long histogram[PROFILE_BUCKETS];
+    };
+
+    struct ProfilePhaseStats profile_phases[NUM_PROFILE_PHASES];
+    _Atomic long profile_counters[NUM_PROFILE_COUNTERS];
+    long profile_generations;
+
+    #define PROFILE_TIMER(phase) long long profile_##phase##_ns = 0, profile_##phase##_start = 0
+    #define PROFILE_START(phase) (profile_##phase##_start = profile_now())
+    #define PROFILE_STOP(phase) (profile_##phase##_ns += profile_now() - profile_##phase##_start)
+    #define PROFILE_FLUSH(phase) ( \
+        atomic_fetch_add_explicit( \
+            &profile_phases[PROFILE_##phase].generation, profile_##phase##_ns, memory_order_relaxed \
+        ), \
+        profile_##phase##_ns = 0 \
+    )
+    #define PROFILE_COUNT(counter, n) atomic_fetch_add_explicit( \
+        &profile_counters[PROFILE_##counter], (n), memory_order_relaxed \
+    )
+    #define PROFILE_GENERATION() profile_generation()
+    #define PROFILE_REPORT() profile_report()
+
+    static inline long long profile_now ();
+    void profile_generation ();
+    void profile_report ();
+    static void format_duration (char * buffer, size_t size, long long ns);
+
+#else
+
+    #define PROFILE_TIMER(phase)
+    #define PROFILE_START(phase) ((void) 0)
+    #define PROFILE_STOP(phase) ((void) 0)
+    #define PROFILE_FLUSH(phase) ((void) 0)
+    #define PROFILE_COUNT(counter, n) ((void) 0)
+    #define PROFILE_GENERATION() ((void) 0)
+    #define PROFILE_REPORT() ((void) 0)
+
+#endif
+
+// -------------------------------------------------------------------------- //
+
+#if PROFILE == TRUE
+
+    static inline long long profile_now () {
+        struct timespec t;
+        clock_gettime(CLOCK_MONOTONIC, &t);
+        return t.tv_sec * 1000000000LL + t.tv_nsec;
+    }
+
+    // Move the Time of the finished Generation into the Histograms.
+    // Must be called while no Thread is measuring anything.
+    void profile_generation () {
+        profile_generations ++;
+        for (int iLauf = 0; iLauf < NUM_PROFILE_PHASES; iLauf ++) {
+            struct ProfilePhaseStats * p = &profile_phases[iLauf];
+            long long ns = atomic_exchange_explicit(&p->generation, 0, memory_order_relaxed);
+            if (ns <= 0) continue;
+
+            int bucket = 63 - __builtin_clzll(ns);
+            if (bucket >= PROFILE_BUCKETS) bucket = PROFILE_BUCKETS - 1;
+            p->histogram[bucket] ++;
+            p->total += ns;
+            p->samples ++;
+            if (ns > p->max) p->max = ns;
+        }
+    }
+
+// -------------------------------------------------------------------------- //
+
+    // Print the Time of every Phase which was measured, with a Histogram of
+    // the Time per Generation, and all Counters.
+    void profile_report () {
+
+        #define PROFILE_NAME(name, description) description,
+        const char * phase_names[] = {PROFILE_PHASES(PROFILE_NAME)};
+        const char * counter_names[] = {PROFILE_COUNTERS(PROFILE_NAME)};
+        #undef PROFILE_NAME
+        char total[32], mean[32], max[32], from[32], to[32];
+
+        fprintf(stderr, "Profile of %ld Generations:\n", profile_generations);
+
+        for (int iLauf = 0; iLauf < NUM_PROFILE_PHASES; iLauf ++) {
+            const struct ProfilePhaseStats * p = &profile_phases[iLauf];
+            if (p->samples == 0) continue;
+
+            format_duration(total, sizeof(total), p->total);
+            format_duration(mean, sizeof(mean), p->total / p->samples);
+            format_duration(max, sizeof(max), p->max);
+            fprintf(
+                stderr, "  %-22s total %s, mean %s, max %s per Generation\n",
+                phase_names[iLauf], total, mean, max
+            );
+
+            // Scale the Bars to the biggest Bucket
+            long biggest = 0;
+            for (int iLauf2 = 0; iLauf2 < PROFILE_BUCKETS; iLauf2 ++) {
+                if (p->histogram[iLauf2] > biggest) biggest = p->histogram[iLauf2];
+            }
+            for (int iLauf2 = 0; iLauf2 < PROFILE_BUCKETS; iLauf2 ++) {
+                if (p->histogram[iLauf2] == 0) continue;
+                format_duration(from, sizeof(from), 1LL << iLauf2);
+                format_duration(to, sizeof(to), 1LL << (iLauf2 + 1));
+                int bar = (40 * p->histogram[iLauf2] + biggest - 1) / biggest;
+                fprintf(
+                    stderr, "    %9s - %9s | %-40.*s %ld\n", from, to, bar,
+                    "########################################", p->histogram[iLauf2]
+                );
+            }
+        }
+
+        for (int iLauf = 0; iLauf < NUM_PROFILE_COUNTERS; iLauf ++) {
+            long count = atomic_load(&profile_counters[iLauf]);
+            if (count == 0) continue;
+            fprintf(
+                stderr, "  %-22s %ld (%.1f per Generation)\n", counter_names[iLauf], count,
+                (double) count / (profile_generations ? profile_generations : 1)
+            );
+        }
+
+    }
+
+    // Format a Duration using the biggest fitting Unit
+    static void format_duration (char * buffer, size_t size, long long ns) {
+        if (ns < 1000LL) {
+            snprintf(buffer, size, "%lld ns", ns);
+        } else if (ns < 1000000LL) {
+            snprintf(buffer, size, "%.1f us", ns / 1e3);
+        } else if (ns < 1000000000LL) {
+            snprintf(buffer, size, "%.1f ms", ns / 1e6);
+        } else {
+            snprintf(buffer, size, "%.2f s", ns / 1e9);
+        }
+    }
+
+#endif
+
+// -------------------------------------------------------------------------- //
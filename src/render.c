@@ -0,0 +1,541 @@
+
+// -------------------------------------------------------------------------- //
+// --- Explanation ---------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Terminal Output which only redraws the Parts that changed since the last
+// Frame.
+//
+// Printing every Cell with its own printf and Colour Code costs more than
+// calculating the Generation. Instead the Variants only write one Byte per
+// Glyph into the current Frame and render_frame compares it with the Frame
+// which is on the Screen:
+//
+//      => Unchanged Glyphs are skipped using a Cursor Movement
+//         (short Gaps are simply printed again, which is shorter)
+//      => The Colour Code is only sent when the Colour changes
+//      => Everything is collected in one Buffer and written with a single
+//         write, so the Terminal gets the whole Frame at once
+//
+// So a Frame only costs as much as the Number of changed Glyphs. The first
+// Frame draws everything, since nothing is on the Screen yet.
+//
+// The Board can be shown in 3 Ways (--view):
+//
+//      cells   => 2 Characters per Cell, " a" (alive) or " d" (dead)
+//      half    => Half Blocks, 1x2 Cells per Character:    ▀ ▄ █
+//      braille => Braille Patterns, 2x4 Cells per Character: ⣿
+//
+// In the half and braille View Boards which are bigger than the Terminal
+// are scaled down: every Pixel of a Glyph then stands for a Square of
+// scale x scale Cells and is set if any of them is alive. These Views are
+// made from packed Rows (1 Bit per Cell), so a whole Word of Cells can be
+// checked at once.
+//
+// With --render-fps only that many Frames are drawn per Second, no matter
+// how fast the Generations are calculated (the ones in between are skipped).
+//
+// With --render-thread the Frames are drawn by a Thread of their own, so the
+// Simulation never waits for the Terminal. Whenever the Render Thread wants
+// a new Frame, the Simulation copies the packed Board into a Snapshot and
+// swaps it in as the latest one using an atomic Pointer Exchange. The Render
+// Thread swaps it out the same Way at its next Frame. With 3 Snapshots each
+// Side always has one to itself, so neither ever waits for the other:
+//
+//      Simulation  --(back)-->  latest  --(front)-->  Render Thread
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/ioctl.h>
+
+// Line of the Terminal the first Row of the Board is drawn into
+#define RENDER_Y_OFFSET 3
+// Gaps of up to this many unchanged Glyphs are printed instead of skipped
+#define RENDER_MAX_GAP 3
+// Most Bytes a single Glyph can take (Cursor Movement + Colour + Glyph)
+#define RENDER_MAX_GLYPH 32
+
+#define RENDER_ALIVE 32
+#define RENDER_DEAD 31
+#define RENDER_HEADER 34
+
+// Frames per Second of the Render Thread if --render-fps is not given
+#define RENDER_THREAD_FPS 30
+
+enum RenderMode {RENDER_CELLS, RENDER_HALF, RENDER_BRAILLE};
+
+struct Renderer {
+    enum RenderMode mode;
+    // Size of the Frame in Glyphs
+    int width;
+    int height;
+    // Size of the Board in Cells
+    int board_width;
+    int board_height;
+    // Cells per Pixel in each Direction
+    int scale;
+    // One Byte per Glyph:
+    // cells         => Bit 7 = alive, the other Bits = Character
+    // half, braille => the Pixels which are set
+    unsigned char * current;
+    // The Frame which is on the Screen
+    unsigned char * previous;
+    bool drawn;
+    // Packed Board for Variants which do not store one (half, braille)
+    uint64_t * bits;
+    long words;
+    // One packed Row of Pixels (half, braille)
+    uint64_t * pixel_row;
+    char * buffer;
+    size_t length;
+    size_t capacity;
+    // Time between two Frames (0 = draw every Frame) and the next Frame
+    long long interval;
+    long long next_frame;
+    // Number of Glyphs redrawn by the last Frame
+    long changed;
+};
+
+// A packed Copy of the Board (words Words per Row)
+struct RenderSnapshot {
+    long round;
+    uint64_t * cells;
+};
+
+struct RenderThread {
+    // Only used by the Render Thread while it runs
+    struct Renderer * renderer;
+    struct RenderSnapshot snapshots[3];
+    // Snapshot the Simulation writes into next
+    struct RenderSnapshot * back;
+    // Snapshot which was published last
+    _Atomic(struct RenderSnapshot *) latest;
+    // Snapshot the Render Thread draws
+    struct RenderSnapshot * front;
+    // Set by the Render Thread once it wants a new Snapshot
+    _Atomic bool wanted;
+    _Atomic bool stop;
+    _Atomic bool failed;
+    pthread_t thread;
+};
+
+// -------------------------------------------------------------------------- //
+
+int parse_render_mode (const char * name, enum RenderMode * mode);
+int init_renderer (struct Renderer * r, enum RenderMode mode, int width, int height, int fps);
+void uninit_renderer (struct Renderer * r);
+bool render_due (const struct Renderer * r);
+void render_rows (struct Renderer * r, const uint64_t * cells, long stride);
+int render_frame (struct Renderer * r, int round);
+static inline unsigned char render_cell (bool alive, char glyph);
+static inline bool any_bit (const uint64_t * row, long begin, long end);
+static inline void render_glyph (struct Renderer * r, unsigned char glyph, int * colour);
+int start_render_thread (struct RenderThread * t, struct Renderer * r);
+int stop_render_thread (struct RenderThread * t);
+uint64_t * render_snapshot (struct RenderThread * t, bool force);
+void publish_snapshot (struct RenderThread * t, long round);
+static int flush_renderer (struct Renderer * r);
+static long long render_now ();
+static void * render_thread_main (void * arg);
+
+// -------------------------------------------------------------------------- //
+
+// Returns -1 if the Name is not one of cells, half and braille
+int parse_render_mode (const char * name, enum RenderMode * mode) {
+    if (strcmp(name, "cells") == 0) {
+        *mode = RENDER_CELLS;
+    } else if (strcmp(name, "half") == 0) {
+        *mode = RENDER_HALF;
+    } else if (strcmp(name, "braille") == 0) {
+        *mode = RENDER_BRAILLE;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+// -------------------------------------------------------------------------- //
+
+// Pixels per Glyph
+static const int PIXEL_WIDTH[] = {[RENDER_CELLS] = 1, [RENDER_HALF] = 1, [RENDER_BRAILLE] = 2};
+static const int PIXEL_HEIGHT[] = {[RENDER_CELLS] = 1, [RENDER_HALF] = 2, [RENDER_BRAILLE] = 4};
+
+// Allocate the Frames for a Board of width x height Cells.
+// The half and braille View are scaled down to fit into the Terminal.
+// Returns -1 if no Memory could be allocated.
+int init_renderer (struct Renderer * r, enum RenderMode mode, int width, int height, int fps) {
+
+    const int pixel_width = PIXEL_WIDTH[mode];
+    const int pixel_height = PIXEL_HEIGHT[mode];
+
+    r->mode = mode;
+    r->board_width = width;
+    r->board_height = height;
+    r->scale = 1;
+
+    if (mode != RENDER_CELLS) {
+        // Size of the Terminal (without the Header)
+        struct winsize size;
+        int columns = 80;
+        int rows = 24;
+        if ((ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0) && (size.ws_col > 0)) {
+            columns = size.ws_col;
+            rows = size.ws_row;
+        }
+        rows -= RENDER_Y_OFFSET - 1;
+        if (rows < 1) rows = 1;
+
+        // Same Scale in both Directions, so the Board keeps its Shape
+        const int scale_x = (width + columns * pixel_width - 1) / (columns * pixel_width);
+        const int scale_y = (height + rows * pixel_height - 1) / (rows * pixel_height);
+        if (scale_x > r->scale) r->scale = scale_x;
+        if (scale_y > r->scale) r->scale = scale_y;
+    }
+
+    r->width = (width + r->scale * pixel_width - 1) / (r->scale * pixel_width);
+    r->height = (height + r->scale * pixel_height - 1) / (r->scale * pixel_height);
+    r->words = (width + 63) / 64;
+    r->drawn = false;
+    r->length = 0;
+    r->changed = 0;
+    r->interval = (fps > 0) ? (1000000000LL / fps) : 0;
+    r->next_frame = 0;
+
+    const size_t glyphs = (size_t) r->width * r->height;
+    // Enough for a whole Frame: one Cursor Movement per Row and a Colour
+    // Change for every Glyph. Frames with more Gaps are written in Parts.
+    r->capacity = glyphs * 8 + (size_t) r->height * RENDER_MAX_GLYPH + 2 * RENDER_MAX_GLYPH * (RENDER_MAX_GAP + 1);
+
+    r->current = calloc(glyphs, 1);
+    r->previous = calloc(glyphs, 1);
+    r->buffer = malloc(r->capacity);
+    r->bits = NULL;
+    r->pixel_row = NULL;
+    if (mode != RENDER_CELLS) {
+        r->bits = calloc((size_t) r->words * height, sizeof(uint64_t));
+        r->pixel_row = malloc(sizeof(uint64_t) * r->words);
+    }
+    if (
+        (r->current == NULL) || (r->previous == NULL) || (r->buffer == NULL) ||
+        ((mode != RENDER_CELLS) && ((r->bits == NULL) || (r->pixel_row == NULL)))
+    ) {
+        uninit_renderer(r);
+        return -1;
+    }
+
+    return 0;
+
+}
+
+void uninit_renderer (struct Renderer * r) {
+    free(r->current);
+    free(r->previous);
+    free(r->buffer);
+    free(r->bits);
+    free(r->pixel_row);
+    r->current = NULL;
+    r->previous = NULL;
+    r->buffer = NULL;
+    r->bits = NULL;
+    r->pixel_row = NULL;
+}
+
+// -------------------------------------------------------------------------- //
+
+// Check if the next Frame should be drawn (with --render-fps Frames are
+// skipped until their Time has come).
+bool render_due (const struct Renderer * r) {
+    return (r->interval == 0) || (render_now() >= r->next_frame);
+}
+
+// Fill the current Frame from packed Rows (Bit x of Row y is Bit x % 64 of
+// Word cells[y * stride + x / 64]). Bits behind the last Cell are ignored.
+void render_rows (struct Renderer * r, const uint64_t * cells, long stride) {
+
+    const int pixel_width = PIXEL_WIDTH[r->mode];
+    const int pixel_height = PIXEL_HEIGHT[r->mode];
+    // Bit of the Glyph for every Pixel (Braille: Dots 1-3 and 7 on the
+    // left, Dots 4-6 and 8 on the right)
+    static const unsigned char PIXEL_BIT[3][4][2] = {
+        [RENDER_CELLS] = {{1}},
+        [RENDER_HALF] = {{1}, {2}},
+        [RENDER_BRAILLE] = {{0x01, 0x08}, {0x02, 0x10}, {0x04, 0x20}, {0x40, 0x80}}
+    };
+
+    if (r->mode == RENDER_CELLS) {
+        unsigned char * frame = r->current;
+        for (long iLauf = 0; iLauf < r->board_height; iLauf ++) {
+            const uint64_t * row = cells + iLauf * stride;
+            for (long iLauf2 = 0; iLauf2 < r->board_width; iLauf2 ++) {
+                const bool alive = (row[iLauf2 / 64] >> (iLauf2 % 64)) & 1;
+                *frame++ = render_cell(alive, alive ? 'a' : 'd');
+            }
+        }
+        return;
+    }
+
+    memset(r->current, 0, (size_t) r->width * r->height);
+
+    for (long y = 0; y < ((long) r->height * pixel_height); y ++) {
+        const long y_begin = y * r->scale;
+        if (y_begin >= r->board_height) break;
+        long y_end = y_begin + r->scale;
+        if (y_end > r->board_height) y_end = r->board_height;
+
+        // A Pixel is set if any Cell of its Rows is alive in its Columns
+        memcpy(r->pixel_row, cells + y_begin * stride, sizeof(uint64_t) * r->words);
+        for (long iLauf = y_begin + 1; iLauf < y_end; iLauf ++) {
+            for (long iLauf2 = 0; iLauf2 < r->words; iLauf2 ++) {
+                r->pixel_row[iLauf2] |= cells[iLauf * stride + iLauf2];
+            }
+        }
+
+        unsigned char * frame = r->current + (y / pixel_height) * r->width;
+        for (long x = 0; x < ((long) r->width * pixel_width); x ++) {
+            const long x_begin = x * r->scale;
+            if (x_begin >= r->board_width) break;
+            long x_end = x_begin + r->scale;
+            if (x_end > r->board_width) x_end = r->board_width;
+            if (any_bit(r->pixel_row, x_begin, x_end)) {
+                frame[x / pixel_width] |= PIXEL_BIT[r->mode][y % pixel_height][x % pixel_width];
+            }
+        }
+    }
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Draw the current Frame, only writing the Glyphs which differ from the
+// previous one, and make it the previous Frame.
+// Returns -1 if the Output could not be written.
+int render_frame (struct Renderer * r, int round) {
+
+    // Output which is still buffered by printf has to come first
+    fflush(stdout);
+
+    if (r->interval > 0) r->next_frame = render_now() + r->interval;
+
+    int colour = RENDER_HEADER;
+    r->length += snprintf(
+        r->buffer + r->length, r->capacity - r->length,
+        "\x1B[1;1H\x1B[%dmRound %d:", RENDER_HEADER, round
+    );
+    if (r->scale > 1) {
+        r->length += snprintf(
+            r->buffer + r->length, r->capacity - r->length,
+            " (1:%d)\x1B[0K", r->scale
+        );
+    }
+    r->changed = 0;
+
+    // Width of a Glyph on the Terminal
+    const int columns = (r->mode == RENDER_CELLS) ? 2 : 1;
+
+    for (int y = 0; y < r->height; y ++) {
+        const unsigned char * now = r->current + (size_t) y * r->width;
+        const unsigned char * before = r->previous + (size_t) y * r->width;
+        // Glyph the Cursor is in front of (-1 => somewhere else)
+        int cursor = -1;
+
+        for (int x = 0; x < r->width; x ++) {
+            if (r->drawn && (now[x] == before[x])) continue;
+
+            if ((r->capacity - r->length) < (RENDER_MAX_GLYPH * (RENDER_MAX_GAP + 1))) {
+                if (flush_renderer(r) < 0) return -1;
+            }
+
+            if ((cursor >= 0) && ((x - cursor) <= RENDER_MAX_GAP)) {
+                // Printing the few Glyphs in between is shorter than moving
+                for (; cursor < x; cursor ++) {
+                    render_glyph(r, now[cursor], &colour);
+                }
+            } else {
+                r->length += snprintf(
+                    r->buffer + r->length, r->capacity - r->length,
+                    "\x1B[%d;%dH", y + RENDER_Y_OFFSET, columns * x + 1
+                );
+            }
+            render_glyph(r, now[x], &colour);
+            cursor = x + 1;
+            r->changed ++;
+        }
+    }
+
+    if (flush_renderer(r) < 0) return -1;
+
+    unsigned char * temp = r->previous;
+    r->previous = r->current;
+    r->current = temp;
+    r->drawn = true;
+
+    return 0;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Encode a Cell for the current Frame of the cells View
+static inline unsigned char render_cell (bool alive, char glyph) {
+    return (alive << 7) | (glyph & 0x7F);
+}
+
+// Check if any of the Bits [begin, end) of the packed Row is set
+static inline bool any_bit (const uint64_t * row, long begin, long end) {
+    const long first = begin / 64;
+    const long last = (end - 1) / 64;
+    const uint64_t head = ~0ULL << (begin % 64);
+    const uint64_t tail = ~0ULL >> (63 - ((end - 1) % 64));
+
+    if (first == last) return (row[first] & head & tail) != 0;
+    if (row[first] & head) return true;
+    for (long iLauf = first + 1; iLauf < last; iLauf ++) {
+        if (row[iLauf]) return true;
+    }
+    return (row[last] & tail) != 0;
+}
+
+// Append a Glyph to the Buffer, changing the Colour only if needed
+static inline void render_glyph (struct Renderer * r, unsigned char glyph, int * colour) {
+
+    const int wanted = ((r->mode != RENDER_CELLS) || (glyph & 0x80)) ? RENDER_ALIVE : RENDER_DEAD;
+    if (*colour != wanted) {
+        r->length += snprintf(r->buffer + r->length, r->capacity - r->length, "\x1B[%dm", wanted);
+        *colour = wanted;
+    }
+
+    if (r->mode == RENDER_CELLS) {
+        r->buffer[r->length++] = ' ';
+        r->buffer[r->length++] = glyph & 0x7F;
+    } else if (glyph == 0) {
+        r->buffer[r->length++] = ' ';
+    } else if (r->mode == RENDER_HALF) {
+        // ▀ (U+2580), ▄ (U+2584) or █ (U+2588) in UTF-8
+        static const unsigned char HALF_BLOCK[] = {0, 0x80, 0x84, 0x88};
+        r->buffer[r->length++] = (char) 0xE2;
+        r->buffer[r->length++] = (char) 0x96;
+        r->buffer[r->length++] = (char) HALF_BLOCK[glyph];
+    } else {
+        // Braille Pattern U+2800 + Dots in UTF-8
+        r->buffer[r->length++] = (char) 0xE2;
+        r->buffer[r->length++] = (char) (0xA0 | (glyph >> 6));
+        r->buffer[r->length++] = (char) (0x80 | (glyph & 0x3F));
+    }
+
+}
+
+// Start drawing the Snapshots in a separate Thread using the Renderer.
+// Returns -1 if the Snapshots could not be allocated or the Thread started.
+int start_render_thread (struct RenderThread * t, struct Renderer * r) {
+
+    t->renderer = r;
+    if (r->interval == 0) r->interval = 1000000000LL / RENDER_THREAD_FPS;
+    for (int iLauf = 0; iLauf < 3; iLauf ++) {
+        t->snapshots[iLauf].round = 0;
+        t->snapshots[iLauf].cells = calloc((size_t) r->words * r->board_height, sizeof(uint64_t));
+        if (t->snapshots[iLauf].cells == NULL) {
+            for (int iLauf2 = 0; iLauf2 < iLauf; iLauf2 ++) free(t->snapshots[iLauf2].cells);
+            return -1;
+        }
+    }
+    t->back = &t->snapshots[0];
+    atomic_init(&t->latest, &t->snapshots[1]);
+    t->front = &t->snapshots[2];
+    atomic_init(&t->wanted, true);
+    atomic_init(&t->stop, false);
+    atomic_init(&t->failed, false);
+
+    if (pthread_create(&t->thread, NULL, render_thread_main, t) != 0) {
+        for (int iLauf = 0; iLauf < 3; iLauf ++) free(t->snapshots[iLauf].cells);
+        return -1;
+    }
+
+    return 0;
+
+}
+
+// Draw the last published Snapshot, stop the Thread and free the Snapshots.
+// Returns -1 if the Render Thread could not write to the Terminal.
+int stop_render_thread (struct RenderThread * t) {
+    atomic_store(&t->stop, true);
+    pthread_join(t->thread, NULL);
+    for (int iLauf = 0; iLauf < 3; iLauf ++) free(t->snapshots[iLauf].cells);
+    return atomic_load(&t->failed) ? -1 : 0;
+}
+
+// Get the Snapshot to copy the Board into (words Words per Row), or NULL if
+// the Render Thread does not want a new one yet. With force the Snapshot is
+// returned anyway (e.g. for the last Round).
+// Every Snapshot which is returned has to be published.
+uint64_t * render_snapshot (struct RenderThread * t, bool force) {
+    if (!atomic_exchange(&t->wanted, false) && !force) return NULL;
+    return t->back->cells;
+}
+
+// Make the Snapshot the latest one and take the one it replaces
+void publish_snapshot (struct RenderThread * t, long round) {
+    t->back->round = round;
+    t->back = atomic_exchange(&t->latest, t->back);
+}
+
+static void * render_thread_main (void * arg) {
+
+    struct RenderThread * t = arg;
+    struct Renderer * r = t->renderer;
+    long drawn = 0;
+    struct Pacer pacer;
+    init_pacer(&pacer, r->interval);
+
+    while (true) {
+        // Checked before taking the Snapshot, so the last one is drawn too
+        const bool stop = atomic_load(&t->stop);
+
+        t->front = atomic_exchange(&t->latest, t->front);
+        // The same Snapshot comes back if nothing new was published
+        if (t->front->round > drawn) {
+            render_rows(r, t->front->cells, r->words);
+            if (render_frame(r, t->front->round) < 0) {
+                atomic_store(&t->failed, true);
+                break;
+            }
+            drawn = t->front->round;
+        }
+        atomic_store(&t->wanted, true);
+        if (stop) break;
+
+        pace(&pacer);
+    }
+
+    return NULL;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Write the whole Buffer to STDOUT
+static int flush_renderer (struct Renderer * r) {
+    size_t done = 0;
+    while (done < r->length) {
+        ssize_t written = write(STDOUT_FILENO, r->buffer + done, r->length - done);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        done += written;
+    }
+    r->length = 0;
+    return 0;
+}
+
+static long long render_now () {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+// -------------------------------------------------------------------------- //
@@ -0,0 +1,91 @@
+
+// -------------------------------------------------------------------------- //
+// --- Explanation ---------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Life-like Rules in the B/S-Notation (https://conwaylife.com/wiki/Rulestring)
+//
+// "B36/S23" => A dead Cell is born if it has 3 or 6 alive Neighbours and an
+//              alive Cell survives if it has 2 or 3 alive Neighbours.
+//
+// Since a Cell only has 9 possible Neighbour Counts (0 - 8), the Rule is
+// turned into a Table with 2 x 9 Entries, which the Variants index using the
+// State of the Cell and its Neighbour Count:
+//
+//      next[alive][neighbours] => Is the Cell alive in the next Generation?
+//
+// This replaces the (neighbours == 2) || (neighbours == 3) Tests and costs the
+// same for every Rule including Conway's.
+//
+// Some Rules with their Names:
+//      B3/S23       => Conway's Game of Life (Default)
+//      B36/S23      => HighLife
+//      B3678/S34678 => Day & Night
+//      B2/S         => Seeds
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+struct Rule {
+    // Bit n is set if a dead Cell with n alive Neighbours is born
+    uint16_t birth;
+    // Bit n is set if an alive Cell with n alive Neighbours survives
+    uint16_t survive;
+    // next[alive][neighbours] => State of the Cell in the next Generation
+    bool next[2][9];
+};
+
+// Is the Neighbour Count n set in the Birth/Survive Mask?
+#define CHECK_RULE_BIT(mask, n) (((mask) >> (n)) & 1)
+
+// Conway's Game of Life (B3/S23)
+#define CONWAY_RULE { \
+    .birth = (1 << 3), \
+    .survive = (1 << 2) | (1 << 3), \
+    .next = { \
+        { false, false, false, true, false, false, false, false, false }, \
+        { false, false, true,  true, false, false, false, false, false }  \
+    } \
+}
+
+// -------------------------------------------------------------------------- //
+
+int parse_rule (const char * str, struct Rule * rule);
+
+// -------------------------------------------------------------------------- //
+
+// Parse a Rule in the B/S-Notation (e.g. "B36/S23", the Letters can also be
+// lowercase) and build its Lookup-Table.
+// Returns -1 if the String is not a valid Rule (rule is left unchanged).
+int parse_rule (const char * str, struct Rule * rule) {
+
+    if ((str == NULL) || (rule == NULL)) return -1;
+
+    uint16_t masks[2] = {0, 0};
+
+    // Both Parts have to be present in the Order B then S, but the Lists
+    // of Neighbour Counts can be empty (e.g. "B2/S").
+    for (int iLauf = 0; iLauf < 2; iLauf ++) {
+        if ((*str != "BS"[iLauf]) && (*str != "bs"[iLauf])) return -1;
+        str ++;
+        while ((*str >= '0') && (*str <= '8')) {
+            masks[iLauf] |= (1 << (*str - '0'));
+            str ++;
+        }
+        if ((iLauf == 0) && (*str++ != '/')) return -1;
+    }
+    if (*str != '\0') return -1;
+
+    rule->birth = masks[0];
+    rule->survive = masks[1];
+    for (int iLauf = 0; iLauf < 9; iLauf ++) {
+        rule->next[0][iLauf] = CHECK_RULE_BIT(rule->birth, iLauf);
+        rule->next[1][iLauf] = CHECK_RULE_BIT(rule->survive, iLauf);
+    }
+
+    return 0;
+
+}
+
+// -------------------------------------------------------------------------- //
@@ -0,0 +1,371 @@
+
+// -------------------------------------------------------------------------- //
+// --- Explanation ---------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Work-Stealing Scheduler which splits a Generation of the Grid-Variants into
+// Tiles and lets a Pool of Threads calculate them.
+//
+// -------------------    -------------------
+// |t0|t1|t2|t3|t4|t5| => Deque Thread 0: [t0 t1 t2]
+// |t6|t7|t8|t9|..|..|    Deque Thread 1: [t3 t4 t5]  ...
+// -------------------
+//
+// At the Start of each Run every Thread gets an equally big Share of the
+// Tiles in its own Deque. It takes Tiles from the Back of its own Deque and
+// once that is empty it steals Tiles from the Front of the other Deques.
+// This way Threads which got the quiet Parts of the Board help out the ones
+// which got the busy Parts, wherever these Hot Spots currently are.
+// The calling Thread takes part in every Run as Thread 0.
+//
+// Usage Manual:
+//
+//      => init_scheduler(&s, threads, width, height)
+//              Split the Board into Tiles and start the Threads
+//              (threads = 0 => one Thread per online CPU)
+//      => init_scheduler_tiles(&s, threads, width, height, tile_w, tile_h)
+//              Same as above but with Tiles of a different Size
+//      => run_tiles(&s, kernel, ctx)
+//              Call kernel(ctx, tile) once for every Tile and return once
+//              all of them are done
+//      => scheduler_thread_index()
+//              Index (0 - threads-1) of the Thread calling the Kernel, e.g.
+//              for Buffers every Thread needs on its own
+//      => uninit_scheduler(&s)
+//              Stop the Threads and print how long each of them was busy
+//              or idle
+//
+// NOTE: Needs the Program to be linked using -pthread.
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+#include <pthread.h>
+
+// Size of a Tile in Cells
+#ifndef TILE_HEIGHT
+    #define TILE_HEIGHT 32
+#endif
+#ifndef TILE_WIDTH
+    #define TILE_WIDTH 256
+#endif
+
+// -------------------------------------------------------------------------- //
+
+// Rectangle of the Board [y_begin, y_end) x [x_begin, x_end)
+struct Tile {
+    int y_begin;
+    int y_end;
+    int x_begin;
+    int x_end;
+};
+
+// Deque of Tile-Indices belonging to one Thread
+// The Owner pops from the Back (tail) and Thieves steal from the Front (head).
+struct TileDeque {
+    pthread_mutex_t lock;
+    long * tiles;
+    long head;
+    long tail;
+};
+
+struct Scheduler;
+
+// Per-Thread State and Statistics
+struct SchedulerThread {
+    pthread_t thread;
+    struct Scheduler * scheduler;
+    int id;
+    // Time spent calculating Tiles and waiting for Work (in Nanoseconds)
+    long long busy;
+    long long idle;
+    long tiles;
+    long stolen;
+};
+
+struct Scheduler {
+    int num_threads;
+    struct SchedulerThread * threads;
+    struct TileDeque * deques;
+    struct Tile * tiles;
+    long num_tiles;
+    int tile_width;
+    int tile_height;
+    // Work of the current Run
+    void (*kernel)(void * ctx, struct Tile tile);
+    void * ctx;
+    pthread_barrier_t start;
+    pthread_barrier_t done;
+    // Held while the Threads are created, so they only start waiting on the
+    // Barriers once it is known how many of them there are.
+    pthread_mutex_t setup;
+    bool stop;
+};
+
+// -------------------------------------------------------------------------- //
+
+int init_scheduler (struct Scheduler * s, int threads, int width, int height);
+int init_scheduler_tiles (struct Scheduler * s, int threads, int width, int height, int tile_width, int tile_height);
+int scheduler_thread_index ();
+void uninit_scheduler (struct Scheduler * s);
+void run_tiles (struct Scheduler * s, void (*kernel)(void * ctx, struct Tile tile), void * ctx);
+static void * scheduler_thread (void * arg);
+static void run_share (struct Scheduler * s, struct SchedulerThread * t);
+static long long work_tiles (struct Scheduler * s, struct SchedulerThread * t);
+static bool take_tile (struct TileDeque * d, bool steal, long * tile);
+static long long now_ns ();
+
+// -------------------------------------------------------------------------- //
+
+// Index of the Thread in the Pool which is running the current Kernel
+static _Thread_local int thread_index = 0;
+
+// -------------------------------------------------------------------------- //
+
+// Split the Board into Tiles and start the Threads.
+// Returns -1 if the Scheduler could not be created.
+int init_scheduler (struct Scheduler * s, int threads, int width, int height) {
+    return init_scheduler_tiles(s, threads, width, height, TILE_WIDTH, TILE_HEIGHT);
+}
+
+int init_scheduler_tiles (
+    struct Scheduler * s, int threads, int width, int height,
+    int tile_width, int tile_height
+) {
+    if ((s == NULL) || (tile_width <= 0) || (tile_height <= 0)) return -1;
+
+    if (threads <= 0) threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads <= 0) threads = 1;
+
+    long tiles_y = (height + tile_height - 1) / tile_height;
+    long tiles_x = (width + tile_width - 1) / tile_width;
+
+    s->num_threads = threads;
+    s->tile_width = tile_width;
+    s->tile_height = tile_height;
+    s->num_tiles = tiles_y * tiles_x;
+    s->stop = false;
+    s->tiles = malloc(sizeof(struct Tile) * s->num_tiles);
+    s->deques = calloc(threads, sizeof(struct TileDeque));
+    s->threads = calloc(threads, sizeof(struct SchedulerThread));
+
+    if ((s->tiles == NULL) || (s->deques == NULL) || (s->threads == NULL)) {
+        free(s->tiles);
+        free(s->deques);
+        free(s->threads);
+        return -1;
+    }
+
+    // Create the Tiles Row by Row
+    long idx = 0;
+    for (long iLauf = 0; iLauf < tiles_y; iLauf ++) {
+        for (long iLauf2 = 0; iLauf2 < tiles_x; iLauf2 ++) {
+            s->tiles[idx].y_begin = iLauf * tile_height;
+            s->tiles[idx].y_end = (iLauf + 1) * tile_height;
+            if (s->tiles[idx].y_end > height) s->tiles[idx].y_end = height;
+            s->tiles[idx].x_begin = iLauf2 * tile_width;
+            s->tiles[idx].x_end = (iLauf2 + 1) * tile_width;
+            if (s->tiles[idx].x_end > width) s->tiles[idx].x_end = width;
+            idx ++;
+        }
+    }
+
+    // Every Deque has to be able to hold all Tiles, because in the worst Case
+    // one Thread gets all of them.
+    for (int iLauf = 0; iLauf < threads; iLauf ++) {
+        s->deques[iLauf].tiles = malloc(sizeof(long) * s->num_tiles);
+        if (s->deques[iLauf].tiles == NULL) {
+            for (; iLauf > 0; iLauf --) free(s->deques[iLauf-1].tiles);
+            free(s->tiles);
+            free(s->deques);
+            free(s->threads);
+            return -1;
+        }
+        pthread_mutex_init(&s->deques[iLauf].lock, NULL);
+        s->threads[iLauf].scheduler = s;
+        s->threads[iLauf].id = iLauf;
+    }
+
+    // The calling Thread is Thread 0, so only start the other ones
+    pthread_mutex_init(&s->setup, NULL);
+    pthread_mutex_lock(&s->setup);
+    for (int iLauf = 1; iLauf < threads; iLauf ++) {
+        if (pthread_create(&s->threads[iLauf].thread, NULL, scheduler_thread, &s->threads[iLauf]) != 0) {
+            // Continue with the Threads which could be started
+            s->num_threads = iLauf;
+            break;
+        }
+    }
+    // Free the Deques of the Threads which could not be started
+    for (int iLauf = s->num_threads; iLauf < threads; iLauf ++) {
+        pthread_mutex_destroy(&s->deques[iLauf].lock);
+        free(s->deques[iLauf].tiles);
+    }
+    pthread_barrier_init(&s->start, NULL, s->num_threads);
+    pthread_barrier_init(&s->done, NULL, s->num_threads);
+    pthread_mutex_unlock(&s->setup);
+
+    return 0;
+}
+
+// -------------------------------------------------------------------------- //
+
+// Stop all Threads, print their Statistics and free the Scheduler
+void uninit_scheduler (struct Scheduler * s) {
+    if (s == NULL) return;
+
+    // Wake up the Threads one last time, so they can exit.
+    s->stop = true;
+    pthread_barrier_wait(&s->start);
+    for (int iLauf = 1; iLauf < s->num_threads; iLauf ++) {
+        pthread_join(s->threads[iLauf].thread, NULL);
+    }
+
+    fprintf(stderr, "Scheduler: %ld Tiles of %dx%d Cells\n",
+        s->num_tiles, s->tile_width, s->tile_height
+    );
+    for (int iLauf = 0; iLauf < s->num_threads; iLauf ++) {
+        fprintf(stderr,
+            "\tThread %2d: busy %10.3f ms, idle %10.3f ms, %8ld Tiles (%ld stolen)\n",
+            iLauf, s->threads[iLauf].busy / 1e6, s->threads[iLauf].idle / 1e6,
+            s->threads[iLauf].tiles, s->threads[iLauf].stolen
+        );
+    }
+
+    pthread_barrier_destroy(&s->start);
+    pthread_barrier_destroy(&s->done);
+    pthread_mutex_destroy(&s->setup);
+    for (int iLauf = 0; iLauf < s->num_threads; iLauf ++) {
+        pthread_mutex_destroy(&s->deques[iLauf].lock);
+        free(s->deques[iLauf].tiles);
+    }
+    free(s->tiles);
+    free(s->deques);
+    free(s->threads);
+}
+
+// -------------------------------------------------------------------------- //
+
+// Call kernel(ctx, tile) for every Tile of the Board using all Threads.
+// Returns once every Tile has been calculated.
+void run_tiles (struct Scheduler * s, void (*kernel)(void * ctx, struct Tile tile), void * ctx) {
+
+    // Give every Thread a contiguous Share of the Tiles
+    for (int iLauf = 0; iLauf < s->num_threads; iLauf ++) {
+        struct TileDeque * d = &s->deques[iLauf];
+        long begin = s->num_tiles * iLauf / s->num_threads;
+        long end = s->num_tiles * (iLauf + 1) / s->num_threads;
+        d->head = 0;
+        d->tail = end - begin;
+        for (long iLauf2 = begin; iLauf2 < end; iLauf2 ++) {
+            d->tiles[iLauf2 - begin] = iLauf2;
+        }
+    }
+
+    s->kernel = kernel;
+    s->ctx = ctx;
+
+    pthread_barrier_wait(&s->start);
+    run_share(s, &s->threads[0]);
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Index of the calling Thread in the Pool (the Thread calling run_tiles is 0)
+int scheduler_thread_index () {
+    return thread_index;
+}
+
+// -------------------------------------------------------------------------- //
+
+// Thread Function of the Threads in the Pool
+static void * scheduler_thread (void * arg) {
+    struct SchedulerThread * t = arg;
+    struct Scheduler * s = t->scheduler;
+
+    thread_index = t->id;
+
+    // Wait until all Threads are created
+    pthread_mutex_lock(&s->setup);
+    pthread_mutex_unlock(&s->setup);
+
+    while (true) {
+        pthread_barrier_wait(&s->start);
+        if (s->stop) break;
+        run_share(s, t);
+    }
+
+    return NULL;
+}
+
+// -------------------------------------------------------------------------- //
+
+// Take part in the current Run and wait until all other Threads are done.
+// Everything but the Time spent inside the Kernel counts as idle.
+static void run_share (struct Scheduler * s, struct SchedulerThread * t) {
+    long long run_start = now_ns();
+    long long busy = work_tiles(s, t);
+    pthread_barrier_wait(&s->done);
+    t->idle += (now_ns() - run_start) - busy;
+}
+
+// -------------------------------------------------------------------------- //
+
+// Calculate Tiles until no Deque contains any more.
+// Since no Tiles are added during a Run, a Thread which found all Deques
+// empty once is done.
+// Returns the Time spent calculating Tiles.
+static long long work_tiles (struct Scheduler * s, struct SchedulerThread * t) {
+
+    long long busy = 0;
+    long long tile_start;
+    long tile;
+
+    while (true) {
+        bool found = take_tile(&s->deques[t->id], false, &tile);
+        // Try to steal from the other Threads, starting with the next one
+        for (int iLauf = 1; (!found) && (iLauf < s->num_threads); iLauf ++) {
+            const int victim = (t->id + iLauf) % s->num_threads;
+            found = take_tile(&s->deques[victim], true, &tile);
+            if (found) {
+                t->stolen ++;
+                TRACE(STEAL, "Thread %ld stole Tile %ld from Thread %ld", t->id, tile, victim);
+            }
+        }
+        if (!found) break;
+
+        tile_start = now_ns();
+        s->kernel(s->ctx, s->tiles[tile]);
+        busy += now_ns() - tile_start;
+        t->tiles ++;
+    }
+
+    t->busy += busy;
+    return busy;
+
+}
+
+// Take a Tile from the Back of the Deque or steal it from the Front.
+// Returns false if the Deque is empty.
+static bool take_tile (struct TileDeque * d, bool steal, long * tile) {
+    bool found = false;
+    pthread_mutex_lock(&d->lock);
+    if (d->head < d->tail) {
+        *tile = steal ? d->tiles[d->head++] : d->tiles[--d->tail];
+        found = true;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return found;
+}
+
+// -------------------------------------------------------------------------- //
+
+static long long now_ns () {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// -------------------------------------------------------------------------- //
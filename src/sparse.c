@@ -0,0 +1,286 @@
+
+// -------------------------------------------------------------------------- //
+// --- Explanation ---------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Binary Dump of the alive Cells of every Generation as a sorted List of
+// Coordinates, for the Complicated Variant whose Universe has no Bounds:
+//
+//      ./game 50 40 0.3 1000 --sparse run.gols
+//
+// Unlike the Terminal (which only shows the Cells inside the Board) the Dump
+// holds every alive Cell, no Matter how far the Patterns drifted away.
+//
+// File Layout:
+//
+//      "GOLS" | u32 Version (Little Endian)                    => Header
+//      Varint Generation | Varint Count | Varint Size | Data   => Generation
+//      ...
+//
+// The Cells of a Generation are sorted by Row and then by Column and stored
+// as the Difference to the Cell before (the first one to (0, 0)):
+//
+//      Varint dy | Varint dx - 1               => Same Row (dy = 0)
+//      Varint dy | Zigzag dx                   => Next Rows (dy > 0)
+//
+// Zigzag maps signed Differences to small unsigned Numbers (0, -1, 1, -2,
+// ... => 0, 1, 2, 3, ...) and a Varint stores 7 Bits per Byte, so Cells
+// which are close to each other only take 2 Bytes. The first Cell stores
+// dy as Zigzag, since the Universe also has negative Rows.
+// Size is the Length of the Data, so a Reader can skip Generations.
+// The Varints are the same as the ones of the Frame Stream (frames.c).
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+#define SPARSE_VERSION 1
+
+struct SparseCell {
+    long y;
+    long x;
+};
+
+struct SparseStream {
+    FILE * file;
+    // Cells of the current Generation
+    struct SparseCell * cells;
+    long count;
+    long capacity;
+    // Encoded Generation
+    unsigned char * data;
+    size_t data_capacity;
+};
+
+// -------------------------------------------------------------------------- //
+
+int open_sparse (struct SparseStream * s, const char * path);
+int close_sparse (struct SparseStream * s);
+int add_sparse_cell (struct SparseStream * s, long y, long x);
+int write_sparse (struct SparseStream * s, long generation);
+int read_sparse_header (FILE * file);
+int read_sparse (FILE * file, long * generation, struct SparseCell ** cells, long * count, long * capacity);
+static int compare_sparse_cells (const void * a, const void * b);
+static int read_sparse_varint (FILE * file, uint64_t * value);
+static inline uint64_t zigzag (long value);
+static inline long unzigzag (uint64_t value);
+
+// -------------------------------------------------------------------------- //
+
+// Create the File and write its Header.
+// Returns -1 if the File could not be opened.
+int open_sparse (struct SparseStream * s, const char * path) {
+
+    s->cells = NULL;
+    s->count = 0;
+    s->capacity = 0;
+    s->data = NULL;
+    s->data_capacity = 0;
+
+    s->file = fopen(path, "wb");
+    if (s->file == NULL) return -1;
+
+    const unsigned char header[8] = {
+        'G', 'O', 'L', 'S', SPARSE_VERSION & 0xFF, (SPARSE_VERSION >> 8) & 0xFF, 0, 0
+    };
+    fwrite(header, 1, sizeof(header), s->file);
+
+    return ferror(s->file) ? -1 : 0;
+
+}
+
+// Close the File and free the Buffers.
+// Does nothing if the Stream was never opened.
+// Returns -1 if the File could not be written.
+int close_sparse (struct SparseStream * s) {
+
+    int result = 0;
+
+    if (s->file != NULL) {
+        if (ferror(s->file)) result = -1;
+        if (fclose(s->file) != 0) result = -1;
+    }
+    free(s->cells);
+    free(s->data);
+    s->file = NULL;
+    s->cells = NULL;
+    s->data = NULL;
+
+    return result;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Add an alive Cell to the current Generation (in any Order).
+// Returns -1 if no Memory could be allocated.
+int add_sparse_cell (struct SparseStream * s, long y, long x) {
+
+    if (s->count == s->capacity) {
+        const long capacity = s->capacity ? (2 * s->capacity) : 1024;
+        struct SparseCell * cells = realloc(s->cells, sizeof(struct SparseCell) * capacity);
+        if (cells == NULL) return -1;
+        s->cells = cells;
+        s->capacity = capacity;
+    }
+
+    s->cells[s->count].y = y;
+    s->cells[s->count].x = x;
+    s->count ++;
+    return 0;
+
+}
+
+// Sort the Cells of the current Generation, write them and start the next
+// Generation.
+// Returns -1 if no Memory could be allocated or the File could not be written.
+int write_sparse (struct SparseStream * s, long generation) {
+
+    // Every Cell takes at most 2 Varints of 10 Bytes
+    const size_t needed = (size_t) s->count * 20;
+    if (needed > s->data_capacity) {
+        unsigned char * data = realloc(s->data, needed);
+        if (data == NULL) return -1;
+        s->data = data;
+        s->data_capacity = needed;
+    }
+
+    qsort(s->cells, s->count, sizeof(struct SparseCell), compare_sparse_cells);
+
+    size_t size = 0;
+    long y = 0, x = 0;
+    for (long iLauf = 0; iLauf < s->count; iLauf ++) {
+        const struct SparseCell * c = &s->cells[iLauf];
+        if (iLauf == 0) {
+            size += put_varint(s->data + size, zigzag(c->y));
+            size += put_varint(s->data + size, zigzag(c->x));
+        } else if (c->y == y) {
+            size += put_varint(s->data + size, 0);
+            size += put_varint(s->data + size, (uint64_t) (c->x - x - 1));
+        } else {
+            size += put_varint(s->data + size, (uint64_t) (c->y - y));
+            size += put_varint(s->data + size, zigzag(c->x - x));
+        }
+        y = c->y;
+        x = c->x;
+    }
+
+    unsigned char header[30];
+    size_t length = put_varint(header, generation);
+    length += put_varint(header + length, s->count);
+    length += put_varint(header + length, size);
+    fwrite(header, 1, length, s->file);
+    fwrite(s->data, 1, size, s->file);
+
+    s->count = 0;
+    return ferror(s->file) ? -1 : 0;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Check the Header at the Start of a Dump.
+// Returns -1 if the File is not a Dump (of this Version).
+int read_sparse_header (FILE * file) {
+    unsigned char header[8];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header)) return -1;
+    if (memcmp(header, "GOLS", 4) != 0) return -1;
+    return ((header[4] | (header[5] << 8)) == SPARSE_VERSION) ? 0 : -1;
+}
+
+// Read the next Generation of a Dump into cells, which grows as needed
+// (capacity holds its Size).
+// Returns 1 at the End of the File and -1 if the Dump is corrupt.
+int read_sparse (FILE * file, long * generation, struct SparseCell ** cells, long * count, long * capacity) {
+
+    uint64_t value, number, size;
+
+    const int first = fgetc(file);
+    if (first == EOF) return 1;
+    ungetc(first, file);
+    if (
+        (read_sparse_varint(file, &value) < 0) || (read_sparse_varint(file, &number) < 0) ||
+        (read_sparse_varint(file, &size) < 0) || (number > (size / 2)) || (size > (number * 20))
+    ) {
+        return -1;
+    }
+    *generation = value;
+
+    unsigned char * data = malloc(size + 1);
+    if (data == NULL) return -1;
+    if (fread(data, 1, size, file) != size) {
+        free(data);
+        return -1;
+    }
+    if ((long) number > *capacity) {
+        struct SparseCell * grown = realloc(*cells, sizeof(struct SparseCell) * number);
+        if (grown == NULL) {
+            free(data);
+            return -1;
+        }
+        *cells = grown;
+        *capacity = number;
+    }
+
+    size_t pos = 0;
+    long y = 0, x = 0;
+    uint64_t dy, dx;
+    for (uint64_t iLauf = 0; iLauf < number; iLauf ++) {
+        if (
+            (get_varint(data, size, &pos, &dy) < 0) ||
+            (get_varint(data, size, &pos, &dx) < 0)
+        ) {
+            free(data);
+            return -1;
+        }
+        if (iLauf == 0) {
+            y = unzigzag(dy);
+            x = unzigzag(dx);
+        } else if (dy == 0) {
+            x += (long) dx + 1;
+        } else {
+            y += (long) dy;
+            x += unzigzag(dx);
+        }
+        (*cells)[iLauf].y = y;
+        (*cells)[iLauf].x = x;
+    }
+    free(data);
+    *count = number;
+
+    return (pos == size) ? 0 : -1;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Sort by Row and then by Column
+static int compare_sparse_cells (const void * a, const void * b) {
+    const struct SparseCell * self = a;
+    const struct SparseCell * other = b;
+    if (self->y != other->y) return (self->y < other->y) ? -1 : 1;
+    if (self->x != other->x) return (self->x < other->x) ? -1 : 1;
+    return 0;
+}
+
+// Returns -1 if the File ends or the Varint has more than 64 Bits
+static int read_sparse_varint (FILE * file, uint64_t * value) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        const int byte = fgetc(file);
+        if (byte == EOF) return -1;
+        *value |= (uint64_t) (byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return 0;
+    }
+    return -1;
+}
+
+static inline uint64_t zigzag (long value) {
+    return ((uint64_t) value << 1) ^ (uint64_t) (value >> 63);
+}
+
+static inline long unzigzag (uint64_t value) {
+    return (long) (value >> 1) ^ -(long) (value & 1);
+}
+
+// -------------------------------------------------------------------------- //
@@ -0,0 +1,234 @@
+
+// -------------------------------------------------------------------------- //
+// --- Explanation ---------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Statistics of every Generation (Population, Births, Deaths, Bounding Box
+// of the alive Cells and the Number of active Tiles) without having to look
+// at the Board again.
+//
+// The Kernels count them while they calculate a Tile, since they already
+// know the old and the new State of every Cell at that Point (the Packed
+// Variant counts 64 Cells at once using popcount). Every Thread adds the
+// Statistics of its Tiles to its own Slot, so no Locks are needed. Once a
+// Generation is done, write_stats merges the Slots and appends one Line to
+// the File given with --stats:
+//
+//      <file>.json / <file>.jsonl => One JSON-Object per Line
+//      everything else            => CSV with a Header
+//
+// A Tile counts as active if at least one of its Cells changed. In the
+// Grid-Variants these are the Tiles of the Scheduler, in the Complicated
+// Variant (which has no Tiles) the Stripes of the Workers.
+// Without --stats the Kernels skip the Counting completely.
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+#include <limits.h>
+
+struct Stats {
+    long population;
+    long births;
+    long deaths;
+    // Bounding Box of the alive Cells (min > max if there are none)
+    long min_x;
+    long min_y;
+    long max_x;
+    long max_y;
+    long active_tiles;
+};
+
+struct StatsStream {
+    FILE * file;
+    bool json;
+    // One Slot per Thread
+    int threads;
+    struct Stats * slots;
+};
+
+// -------------------------------------------------------------------------- //
+
+int open_stats (struct StatsStream * s, const char * path, int threads);
+void close_stats (struct StatsStream * s);
+int write_stats (struct StatsStream * s, long generation);
+void reset_stats (struct Stats * s);
+void merge_stats (struct Stats * dest, const struct Stats * src);
+void add_tile_stats (struct Stats * dest, const struct Stats * tile);
+void shift_stats (struct Stats * s, long dx, long dy);
+static inline void count_cell (struct Stats * s, bool before, bool after, long x, long y);
+static inline void count_words (struct Stats * s, const uint64_t * before, const uint64_t * after, long y, long w_begin, long w_end, uint64_t last_mask);
+
+// -------------------------------------------------------------------------- //
+
+// Open the File and allocate a Slot for every Thread.
+// Returns -1 if the File could not be opened or no Memory could be allocated.
+int open_stats (struct StatsStream * s, const char * path, int threads) {
+
+    const char * extension = strrchr(path, '.');
+    s->json = (extension != NULL) && (
+        (strcmp(extension, ".json") == 0) || (strcmp(extension, ".jsonl") == 0)
+    );
+
+    s->threads = threads;
+    s->slots = malloc(sizeof(struct Stats) * threads);
+    if (s->slots == NULL) return -1;
+    for (int iLauf = 0; iLauf < threads; iLauf ++) {
+        reset_stats(&s->slots[iLauf]);
+    }
+
+    s->file = fopen(path, "w");
+    if (s->file == NULL) {
+        free(s->slots);
+        s->slots = NULL;
+        return -1;
+    }
+
+    if (!s->json) {
+        fprintf(s->file, "generation,population,births,deaths,min_x,min_y,max_x,max_y,active_tiles\n");
+    }
+
+    return 0;
+
+}
+
+void close_stats (struct StatsStream * s) {
+    if (s->file == NULL) return;
+    fclose(s->file);
+    free(s->slots);
+    s->file = NULL;
+    s->slots = NULL;
+}
+
+// Merge the Slots of all Threads, write them as the Statistics of the
+// Generation and reset the Slots for the next one.
+// Returns -1 if the Line could not be written.
+int write_stats (struct StatsStream * s, long generation) {
+
+    struct Stats total;
+    reset_stats(&total);
+    for (int iLauf = 0; iLauf < s->threads; iLauf ++) {
+        merge_stats(&total, &s->slots[iLauf]);
+        reset_stats(&s->slots[iLauf]);
+    }
+
+    const bool empty = total.population == 0;
+
+    if (s->json) {
+        fprintf(
+            s->file, "{\"generation\": %ld, \"population\": %ld, \"births\": %ld, \"deaths\": %ld, ",
+            generation, total.population, total.births, total.deaths
+        );
+        if (empty) {
+            fprintf(s->file, "\"bbox\": null, ");
+        } else {
+            fprintf(
+                s->file, "\"bbox\": [%ld, %ld, %ld, %ld], ",
+                total.min_x, total.min_y, total.max_x, total.max_y
+            );
+        }
+        fprintf(s->file, "\"active_tiles\": %ld}\n", total.active_tiles);
+    } else {
+        fprintf(
+            s->file, "%ld,%ld,%ld,%ld,", generation, total.population, total.births, total.deaths
+        );
+        // An empty Board has no Bounding Box
+        if (empty) {
+            fprintf(s->file, ",,,,");
+        } else {
+            fprintf(s->file, "%ld,%ld,%ld,%ld,", total.min_x, total.min_y, total.max_x, total.max_y);
+        }
+        fprintf(s->file, "%ld\n", total.active_tiles);
+    }
+
+    return ferror(s->file) ? -1 : 0;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+void reset_stats (struct Stats * s) {
+    s->population = 0;
+    s->births = 0;
+    s->deaths = 0;
+    s->min_x = LONG_MAX;
+    s->min_y = LONG_MAX;
+    s->max_x = LONG_MIN;
+    s->max_y = LONG_MIN;
+    s->active_tiles = 0;
+}
+
+void merge_stats (struct Stats * dest, const struct Stats * src) {
+    dest->population += src->population;
+    dest->births += src->births;
+    dest->deaths += src->deaths;
+    if (src->min_x < dest->min_x) dest->min_x = src->min_x;
+    if (src->min_y < dest->min_y) dest->min_y = src->min_y;
+    if (src->max_x > dest->max_x) dest->max_x = src->max_x;
+    if (src->max_y > dest->max_y) dest->max_y = src->max_y;
+    dest->active_tiles += src->active_tiles;
+}
+
+// Add the Statistics of a single Tile, counting it as active if any of its
+// Cells changed.
+void add_tile_stats (struct Stats * dest, const struct Stats * tile) {
+    merge_stats(dest, tile);
+    if ((tile->births + tile->deaths) > 0) dest->active_tiles ++;
+}
+
+// Move the Bounding Box, for Kernels which count in the Coordinates of a
+// Buffer or a Tile instead of the Board.
+void shift_stats (struct Stats * s, long dx, long dy) {
+    if (s->population == 0) return;
+    s->min_x += dx;
+    s->max_x += dx;
+    s->min_y += dy;
+    s->max_y += dy;
+}
+
+// -------------------------------------------------------------------------- //
+
+// Count a single Cell at (x, y)
+static inline void count_cell (struct Stats * s, bool before, bool after, long x, long y) {
+    s->births += !before & after;
+    s->deaths += before & !after;
+    if (!after) return;
+    s->population ++;
+    if (x < s->min_x) s->min_x = x;
+    if (x > s->max_x) s->max_x = x;
+    if (y < s->min_y) s->min_y = y;
+    if (y > s->max_y) s->max_y = y;
+}
+
+// Count the Words [w_begin, w_end) of Row y, which hold 64 Cells each.
+// last_mask is applied to the last Word of before (it is ~0 unless the
+// Padding behind the last Cell could be set).
+static inline void count_words (
+    struct Stats * s, const uint64_t * before, const uint64_t * after,
+    long y, long w_begin, long w_end, uint64_t last_mask
+) {
+    long first = -1, last = -1;
+
+    for (long iLauf = w_begin; iLauf < w_end; iLauf ++) {
+        uint64_t old = before[iLauf];
+        if (iLauf == (w_end - 1)) old &= last_mask;
+        s->population += __builtin_popcountll(after[iLauf]);
+        s->births += __builtin_popcountll(after[iLauf] & ~old);
+        s->deaths += __builtin_popcountll(old & ~after[iLauf]);
+        if (after[iLauf] != 0) {
+            if (first < 0) first = iLauf;
+            last = iLauf;
+        }
+    }
+
+    if (first < 0) return;
+    long min_x = 64 * first + __builtin_ctzll(after[first]);
+    long max_x = 64 * last + 63 - __builtin_clzll(after[last]);
+    if (min_x < s->min_x) s->min_x = min_x;
+    if (max_x > s->max_x) s->max_x = max_x;
+    if (y < s->min_y) s->min_y = y;
+    if (y > s->max_y) s->max_y = y;
+}
+
+// -------------------------------------------------------------------------- //
@@ -0,0 +1,321 @@
+
+// -------------------------------------------------------------------------- //
+// --- Explanation ---------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+// Tracing of internal Events (Comparisons, Chunk Allocations, stolen Tiles,
+// ...) which can be switched on at Runtime, per Category:
+//
+//      ./game 50 40 0.3 100 --trace compare,new_chunk --trace-file trace.log
+//      ./game 50 40 0.3 100 --trace all
+//
+// A Trace Point only costs a Branch on a global Mask while its Category is
+// off, so they can stay in the hot Loops of every Build:
+//
+//      TRACE(COMPARE, "Compare Cell (%ld, %ld)", cell->y, cell->x);
+//
+// The Trace Point does not format anything. It only copies the Format and
+// up to 4 Arguments (as long) into a Record of a Ring Buffer, which any
+// Number of Threads can write to without Locks. A separate Flusher Thread
+// formats the Records and writes them to the Trace File (default STDERR),
+// so the Threads calculating the Board never wait for the Output.
+// If the Ring is full the Record is dropped (and counted) instead of
+// waiting for the Flusher.
+// Every Line shows the Time since the Start, the Thread (numbered in the
+// Order they first traced something), the Category and the Message.
+//
+// Since the Arguments are stored as long, the Format may only use %ld/%lx.
+// Pointers can be traced using %#lx.
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+// Number of Records in the Ring (Power of 2)
+#ifndef TRACE_RING_SIZE
+    #define TRACE_RING_SIZE (1UL << 15)
+#endif
+
+// Categories which can be traced
+// CATEGORY(Name, Name on the Command Line)
+#define TRACE_CATEGORIES(CATEGORY) \
+    CATEGORY(ITERATOR,    "iterator") \
+    CATEGORY(COMPARE,     "compare") \
+    CATEGORY(NEIGHBOURS,  "neighbours") \
+    CATEGORY(CREATE_TEMP, "create_temp") \
+    CATEGORY(REVIVE,      "revive") \
+    CATEGORY(KILL,        "kill") \
+    CATEGORY(REDIRECTION, "redirection") \
+    CATEGORY(CELL_ASSIGN, "cell_assign") \
+    CATEGORY(CELL_REMOVE, "cell_remove") \
+    CATEGORY(NEW_CHUNK,   "new_chunk") \
+    CATEGORY(FREE_CHUNKS, "free_chunks") \
+    CATEGORY(STEAL,       "steal")
+
+#define TRACE_INDEX(name, label) TRACE_INDEX_##name,
+enum TraceIndex {TRACE_CATEGORIES(TRACE_INDEX) NUM_TRACE_CATEGORIES};
+#undef TRACE_INDEX
+
+#define TRACE_BIT(name, label) TRACE_##name = 1U << TRACE_INDEX_##name,
+enum TraceCategory {TRACE_CATEGORIES(TRACE_BIT)};
+#undef TRACE_BIT
+
+#define TRACE_ALL ((1U << NUM_TRACE_CATEGORIES) - 1)
+
+// Record a Trace Point if its Category is enabled.
+// The missing Arguments are filled up with 0.
+#define TRACE(category, ...) TRACE_RECORD(TRACE_##category, __VA_ARGS__, 0, 0, 0, 0, 0)
+#define TRACE_RECORD(category, format, a, b, c, d, ...) ( \
+    __builtin_expect((trace_mask & (category)) != 0, 0) \
+        ? trace_record(category, format, (long) (a), (long) (b), (long) (c), (long) (d)) \
+        : (void) 0 \
+)
+
+// A Record fills exactly one Cache Line
+struct TraceRecord {
+    // Position in the Ring this Slot is ready for:
+    // pos     => free for the Writer of Position pos
+    // pos + 1 => written, ready for the Flusher
+    _Alignas(64) _Atomic unsigned long sequence;
+    long long time;
+    const char * format;
+    unsigned category;
+    int thread;
+    long args[4];
+};
+
+struct TraceRing {
+    struct TraceRecord * records;
+    // Next Position to write (shared by all Threads)
+    _Atomic unsigned long head;
+    // Next Position to flush (only used by the Flusher)
+    unsigned long tail;
+    _Atomic long dropped;
+    long long start;
+    FILE * file;
+    pthread_t flusher;
+    _Atomic bool stop;
+};
+
+// Categories which are currently enabled
+unsigned trace_mask = 0;
+struct TraceRing trace_ring;
+
+// -------------------------------------------------------------------------- //
+
+int parse_trace_categories (const char * list, unsigned * mask);
+int start_trace (unsigned categories, const char * path);
+void stop_trace ();
+void trace_record (unsigned category, const char * format, long a, long b, long c, long d);
+static void * trace_flusher (void * arg);
+static long flush_trace (struct TraceRing * r);
+static long long trace_now ();
+
+// -------------------------------------------------------------------------- //
+
+// Parse a Comma separated List of Categories (or "all") into a Mask.
+// Returns -1 if a Category is unknown.
+int parse_trace_categories (const char * list, unsigned * mask) {
+
+    #define TRACE_LABEL(name, label) label,
+    const char * labels[] = {TRACE_CATEGORIES(TRACE_LABEL)};
+    #undef TRACE_LABEL
+
+    *mask = 0;
+    while (*list != '\0') {
+        size_t len = strcspn(list, ",");
+        bool found = false;
+
+        if ((len == 3) && (strncmp(list, "all", 3) == 0)) {
+            *mask |= TRACE_ALL;
+            found = true;
+        }
+        for (int iLauf = 0; (!found) && (iLauf < NUM_TRACE_CATEGORIES); iLauf ++) {
+            if ((strlen(labels[iLauf]) == len) && (strncmp(list, labels[iLauf], len) == 0)) {
+                *mask |= 1U << iLauf;
+                found = true;
+            }
+        }
+        if (!found) return -1;
+
+        list += len;
+        if (*list == ',') list ++;
+    }
+
+    return 0;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Enable the Categories and start the Flusher writing to the File at path
+// (NULL => STDERR). Does nothing if no Category is enabled.
+// Returns -1 if the File could not be opened or the Flusher not started.
+int start_trace (unsigned categories, const char * path) {
+
+    struct TraceRing * r = &trace_ring;
+    if (categories == 0) return 0;
+
+    r->records = aligned_alloc(_Alignof(struct TraceRecord), sizeof(struct TraceRecord) * TRACE_RING_SIZE);
+    if (r->records == NULL) return -1;
+    for (unsigned long iLauf = 0; iLauf < TRACE_RING_SIZE; iLauf ++) {
+        atomic_init(&r->records[iLauf].sequence, iLauf);
+    }
+    atomic_init(&r->head, 0);
+    atomic_init(&r->dropped, 0);
+    atomic_init(&r->stop, false);
+    r->tail = 0;
+    r->start = trace_now();
+
+    r->file = (path == NULL) ? stderr : fopen(path, "w");
+    if (r->file == NULL) {
+        free(r->records);
+        r->records = NULL;
+        return -1;
+    }
+
+    if (pthread_create(&r->flusher, NULL, trace_flusher, r) != 0) {
+        if (r->file != stderr) fclose(r->file);
+        free(r->records);
+        r->records = NULL;
+        return -1;
+    }
+
+    trace_mask = categories;
+    return 0;
+
+}
+
+// Disable all Categories, write the remaining Records and close the File.
+// Must be called once no Thread traces anymore.
+void stop_trace () {
+
+    struct TraceRing * r = &trace_ring;
+    if (r->records == NULL) return;
+
+    trace_mask = 0;
+    atomic_store(&r->stop, true);
+    pthread_join(r->flusher, NULL);
+    flush_trace(r);
+
+    long dropped = atomic_load(&r->dropped);
+    if (dropped > 0) {
+        fprintf(r->file, "%ld Records were dropped because the Ring was full\n", dropped);
+    }
+
+    if (r->file != stderr) {
+        fclose(r->file);
+    } else {
+        fflush(r->file);
+    }
+    free(r->records);
+    r->records = NULL;
+
+}
+
+// -------------------------------------------------------------------------- //
+
+// Claim the next free Slot of the Ring and fill it.
+// Called through the TRACE-Macro, so only if the Category is enabled.
+void trace_record (unsigned category, const char * format, long a, long b, long c, long d) {
+
+    static _Atomic int num_threads = 0;
+    static _Thread_local int thread = -1;
+    if (thread < 0) thread = atomic_fetch_add_explicit(&num_threads, 1, memory_order_relaxed);
+
+    struct TraceRing * r = &trace_ring;
+    struct TraceRecord * slot;
+    unsigned long pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+
+    while (true) {
+        slot = &r->records[pos & (TRACE_RING_SIZE - 1)];
+        unsigned long sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        long diff = (long) (sequence - pos);
+
+        if (diff == 0) {
+            // The Slot is free, try to claim it (on Failure pos is reloaded)
+            if (atomic_compare_exchange_weak_explicit(
+                &r->head, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed
+            )) break;
+        } else if (diff < 0) {
+            // The Slot still holds a Record from the last Lap => Ring is full
+            atomic_fetch_add_explicit(&r->dropped, 1, memory_order_relaxed);
+            return;
+        } else {
+            // Another Thread claimed the Slot first
+            pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+        }
+    }
+
+    slot->time = trace_now() - r->start;
+    slot->format = format;
+    slot->category = __builtin_ctz(category);
+    slot->thread = thread;
+    slot->args[0] = a;
+    slot->args[1] = b;
+    slot->args[2] = c;
+    slot->args[3] = d;
+    // Hand the Slot to the Flusher
+    atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+
+}
+
+// -------------------------------------------------------------------------- //
+
+static void * trace_flusher (void * arg) {
+
+    struct TraceRing * r = arg;
+    const struct timespec pause = {.tv_sec = 0, .tv_nsec = 1000000};
+
+    while (!atomic_load(&r->stop)) {
+        if (flush_trace(r) == 0) {
+            fflush(r->file);
+            nanosleep(&pause, NULL);
+        }
+    }
+
+    return NULL;
+
+}
+
+// Write all Records which are ready (in Order) and free their Slots.
+// Returns the Number of written Records.
+static long flush_trace (struct TraceRing * r) {
+
+    #define TRACE_LABEL(name, label) label,
+    const char * labels[] = {TRACE_CATEGORIES(TRACE_LABEL)};
+    #undef TRACE_LABEL
+
+    long count = 0;
+
+    while (true) {
+        struct TraceRecord * slot = &r->records[r->tail & (TRACE_RING_SIZE - 1)];
+        if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != (r->tail + 1)) break;
+
+        fprintf(
+            r->file, "%12.6f T%-2d %-11s ",
+            slot->time / 1e9, slot->thread, labels[slot->category]
+        );
+        fprintf(r->file, slot->format, slot->args[0], slot->args[1], slot->args[2], slot->args[3]);
+        fputc('\n', r->file);
+
+        // The Slot is free again for the next Lap
+        atomic_store_explicit(&slot->sequence, r->tail + TRACE_RING_SIZE, memory_order_release);
+        r->tail ++;
+        count ++;
+    }
+
+    return count;
+
+}
+
+static long long trace_now () {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+// -------------------------------------------------------------------------- //